@@ -5,10 +5,11 @@
  */
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include "SFML/Graphics/Font.hpp"
 #include "SFML/Graphics/Texture.hpp"
-#include "game/Arena.h"
+#include "game/Level.h"
 
 sf::Color fromHSL(float h, float s, float l);
 
@@ -32,24 +33,25 @@ public:
     [[nodiscard]] sf::Font &getFont(const std::string &id);
 
 
-    bool loadLevel(const std::string &filePath, const std::string &id);
+    /* sharedTextures are packed into the level's atlas, they must already be loaded */
+    bool loadLevel(const std::string &filePath, const std::string &id,
+                   const std::vector<std::string> &sharedTextures = {});
     /* Loads a level from a file and uses the filepath as the id */
     bool loadLevel(const std::string &filePath) { return loadLevel(filePath, filePath); }
 
-    [[nodiscard]] Arena &getLevel(const std::string &id);
+    /* Levels are shared by every run and never change once loaded */
+    [[nodiscard]] std::shared_ptr<const Level> getLevel(const std::string &id);
 
     void clean();
 
 private:
-    static AssetManager S_instance;
-
     AssetManager() = default;
 
     std::unordered_map<std::string, sf::Texture> m_textures;
     std::unordered_map<std::string, sf::Font> m_fonts;
-    std::unordered_map<std::string, Arena> m_arenas;
+    std::unordered_map<std::string, std::shared_ptr<const Level>> m_levels;
 
     sf::Font m_defaultFont{};
     sf::Texture m_defaultTexture{};
-    Arena m_defaultArena{};
+    std::shared_ptr<const Level> m_defaultLevel = std::make_shared<const Level>();
 };
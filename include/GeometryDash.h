@@ -9,6 +9,7 @@
 
 #include "MainMenuState.h"
 #include "Window.h"
+#include "gui/ProfilerOverlay.h"
 
 class GeometryDash
 {
@@ -27,23 +28,42 @@ public:
     Window &getWindow() { return m_window; }
     sf::Clock &getClock() { return m_clock; }
 
+    /* Real time the last frame took, for anything that isn't simulated */
     sf::Time getDeltaTime() const { return m_deltaTime; }
+    /* Length of one simulation tick, the only time step the simulation ever sees */
+    sf::Time getTickTime() const { return m_tickTime; }
+    /* How far between the last two ticks the frame is rendered, 0 is the previous tick and 1 the latest */
+    float getInterpolation() const { return m_interpolation; }
 
     static bool RenderCollisionShapes;
     static bool EnableDebug;
     static bool EnableVSync;
     static bool Restart;
+    // Simulation ticks per second, independent of the display refresh rate
+    static int SimTickRate;
 
     static void Reset();
+    /* Sets SimTickRate and the tick time, clamped to what the simulation supports */
+    static void SetTickRate(int rate);
 
 private:
     // Singleton
-    static GeometryDash S_instance;
-
     GeometryDash() = default;
 
     std::shared_ptr<State> m_state;
     Window m_window;
+    ProfilerOverlay m_profilerOverlay;
     sf::Clock m_clock;
     sf::Time m_deltaTime;
+    sf::Time m_tickTime = sf::seconds(1.0f / 240);
+    float m_interpolation = 1;
+
+    /* F3 turns the profiler on and off, F4 saves what it recorded to PROFILER_TRACE_PATH */
+    void handleProfilerEvent(const sf::Event &event);
+    static constexpr const char *PROFILER_TRACE_PATH = "profile-trace.json";
+
+    // Longest frame the simulation catches up on, anything longer is dropped rather than simulated
+    static constexpr float MAX_FRAME_TIME = 0.25f;
+    static constexpr int MIN_TICK_RATE = 30;
+    static constexpr int MAX_TICK_RATE = 1000;
 };
@@ -0,0 +1,38 @@
+/*
+ * MappedFile.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+/* Read only view of a whole file mapped into memory */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    [[nodiscard]] bool open(const std::string &filePath);
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+    [[nodiscard]] std::span<const std::byte> getData() const { return {m_data, m_size}; }
+
+private:
+    const std::byte *m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif // WIN32
+};
@@ -9,6 +9,7 @@
 #include "State.h"
 #include "game/Arena.h"
 #include "game/Player.h"
+#include "game/Replay.h"
 #include "gui/Button.h"
 
 class PlayState final : public State
@@ -18,6 +19,7 @@ public:
     ~PlayState() override;
     std::string getName() override { return "Play"; }
 
+    void tick() override;
     void update() override;
     void render() override;
     void handleEvent(const sf::Event &event) override;
@@ -49,11 +51,22 @@ private:
     Arena m_arena;
     Player m_player{};
 
+    // Input of the current run and of the last one that ended. The last run is only written to
+    // LAST_REPLAY_PATH on F5 or when play is left, dying doesn't touch the disk
+    static constexpr const char *LAST_REPLAY_PATH = "last-run.replay";
+    Replay m_replay;
+    Replay m_lastReplay;
+    uint32_t m_tick = 0;
+
     double m_updateCount = 1.0;
     int m_avgFPS = 0;
 
     void openSettings();
     void openPause();
+    /* Starts a new run in place, the assets, buttons and level are kept */
+    void restart();
+    /* Writes the last finished run to LAST_REPLAY_PATH, if there is one */
+    void saveLastReplay() const;
 
     float m_hue;
     sf::Color m_backgroundColor{0, 0, 200};
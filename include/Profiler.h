@@ -0,0 +1,124 @@
+/*
+ * Profiler.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/* One finished zone, times are nanoseconds since the profiler was created */
+struct ProfileEvent
+{
+    // Zone names are string literals, only the pointer is kept
+    const char *name = nullptr;
+    int64_t start = 0;
+    int64_t duration = 0;
+    // How many zones were open around it on its thread
+    uint32_t depth = 0;
+};
+
+/* Time spent in one zone per frame, averaged over the last frames */
+struct ZoneStats
+{
+    const char *name = nullptr;
+    uint32_t depth = 0;
+    double milliseconds = 0;
+    double calls = 0;
+};
+
+/* Records timing zones into a ring buffer per thread, for the frame breakdown and for Chrome traces
+ * (chrome://tracing or ui.perfetto.dev). While disabled a zone costs one relaxed load and records nothing */
+class Profiler
+{
+public:
+    static Profiler &getInstance();
+
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    [[nodiscard]] static bool IsEnabled() { return Enabled.load(std::memory_order_relaxed); }
+    static void SetEnabled(bool enabled);
+
+    [[nodiscard]] int64_t now() const;
+    void record(const ProfileEvent &event);
+
+    /* Ends the frame of the calling thread and folds its zones into the frame stats */
+    void endFrame();
+    /* The zones of the thread calling endFrame, in the order they first ran */
+    [[nodiscard]] const std::vector<ZoneStats> &getFrameStats() const { return m_frameStats; }
+    [[nodiscard]] double getFrameMilliseconds() const { return m_frameMilliseconds; }
+
+    /* Writes what the ring buffers still hold as Chrome trace json. Zones finishing on other threads while saving
+     * can be left out */
+    bool saveChromeTrace(const std::string &filePath) const;
+    /* Forgets every event and the frame stats */
+    void clear();
+
+    // Events kept per thread, about a second of frames at the default tick rate with every zone open
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+private:
+    Profiler();
+
+    struct ThreadBuffer
+    {
+        // Only contended while a trace is saved
+        mutable std::mutex mutex;
+        std::vector<ProfileEvent> events = std::vector<ProfileEvent>(BUFFER_SIZE);
+        // Every event ever recorded, the latest BUFFER_SIZE of them are still in events
+        uint64_t written = 0;
+        // Where the last frame ended, for endFrame
+        uint64_t frameStart = 0;
+        uint32_t id = 0;
+    };
+
+    ThreadBuffer &getThreadBuffer();
+
+    static std::atomic<bool> Enabled;
+
+    std::chrono::steady_clock::time_point m_epoch;
+    int64_t m_lastFrame = 0;
+
+    mutable std::mutex m_buffersMutex;
+    // Buffers outlive their threads so what they recorded can still be saved
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+
+    std::vector<ZoneStats> m_frameStats;
+    double m_frameMilliseconds = 0;
+    // Weight of the latest frame in the averages
+    static constexpr double FRAME_SMOOTHING = 0.1;
+};
+
+/* Times the scope it lives in while the profiler is enabled */
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char *name) : m_name(name)
+    {
+        if (Profiler::IsEnabled())
+            begin();
+    }
+    ~ProfileZone()
+    {
+        if (m_start >= 0)
+            end();
+    }
+
+    ProfileZone(const ProfileZone &) = delete;
+    ProfileZone &operator=(const ProfileZone &) = delete;
+
+private:
+    void begin();
+    void end();
+
+    const char *m_name;
+    int64_t m_start = -1;
+    uint32_t m_depth = 0;
+};
@@ -17,6 +17,8 @@ public:
     virtual std::string getName() = 0;
 
     virtual void handleEvent(const sf::Event &event) {}
+    /* Advances the simulation by one GeometryDash::getTickTime, runs as many times a frame as needed before update */
+    virtual void tick() {}
     virtual void update() = 0;
     virtual void render() = 0;
 
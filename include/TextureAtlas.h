@@ -0,0 +1,59 @@
+/*
+ * TextureAtlas.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SFML/Graphics/Image.hpp"
+#include "SFML/Graphics/Rect.hpp"
+#include "SFML/Graphics/Texture.hpp"
+
+struct AtlasRegion
+{
+    size_t page = 0;
+    sf::IntRect rect{};
+};
+
+/* Packs many images into as few textures as possible so they can be drawn in a single batch */
+class TextureAtlas
+{
+public:
+    static constexpr unsigned MAX_PAGE_SIZE = 2048;
+    static constexpr unsigned PADDING = 1;
+
+    TextureAtlas() = default;
+    ~TextureAtlas() = default;
+
+    /* Queues an image for packing, nothing is uploaded until build is called.
+     * Smooth images get their own pages since filtering is set per texture */
+    void add(const std::string &id, const sf::Image &image, bool smooth = false);
+    [[nodiscard]] bool build();
+
+    [[nodiscard]] bool contains(const std::string &id) const { return m_regions.contains(id); }
+    [[nodiscard]] const AtlasRegion &getRegion(const std::string &id) const;
+
+    [[nodiscard]] size_t getPageCount() const { return m_pages.size(); }
+    [[nodiscard]] const std::shared_ptr<sf::Texture> &getPage(size_t page) const { return m_pages[page]; }
+
+    void clear();
+
+private:
+    struct PendingImage
+    {
+        std::string id;
+        sf::Image image;
+        bool smooth = false;
+    };
+    std::vector<PendingImage> m_pending;
+
+    std::unordered_map<std::string, AtlasRegion> m_regions;
+    std::vector<std::shared_ptr<sf::Texture>> m_pages;
+
+    AtlasRegion m_defaultRegion{};
+};
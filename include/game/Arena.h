@@ -6,39 +6,94 @@
 #pragma once
 
 #include "game/ArenaItem.h"
+#include "game/Level.h"
 
 #include <SFML/System/Vector2.hpp>
 #include <cstdint>
-#include <string>
-#include <unordered_map>
+#include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
+/* How far a run has scrolled, all of a run collisions depend on. Animations are left out */
+struct ArenaScroll
+{
+    sf::Vector2f position;
+    sf::Vector2f previousPosition;
+};
+
+/* A single run through a level, the level itself is shared and never copied */
 class Arena
 {
 public:
     Arena() = default;
     ~Arena() = default;
 
-    [[nodiscard]] bool loadFromFile(const std::string &filePath);
+    /* Starts a new run of level */
+    void setLevel(const std::shared_ptr<const Level> &level);
+    [[nodiscard]] const Level &getLevel() const { return *m_level; }
+
+    /* Scrolls and animates the arena by one simulation tick of dt seconds */
+    void update(float dt);
+    /* alpha is how far from the previous tick to the latest one the arena is drawn */
+    void render(const sf::Vector2f &cameraPos, sf::Color tint, float alpha = 1);
 
-    void update();
-    void render(const sf::Vector2f &cameraPos, sf::Color tint);
+    [[nodiscard]] sf::Vector2i getTileSize() const { return m_level->getTileSize(); }
 
-    [[nodiscard]] sf::Vector2i getTileSize() const { return m_tileSize; }
+    [[nodiscard]] const TextureAtlas &getAtlas() const { return m_level->getAtlas(); }
+    /* Where a tile's frame lives in the atlas, flip flags must already be cleared */
+    [[nodiscard]] const AtlasRegion &getTileRegion(const uint32_t gid) const { return m_level->getTileRegion(gid); }
 
-    [[nodiscard]] sf::Vector2i getSize() const { return m_size; }
+    [[nodiscard]] sf::Vector2i getSize() const { return m_level->getSize(); }
     [[nodiscard]] sf::Vector2f getPosition() const { return m_position; }
-    void setPosition(const sf::Vector2f &position) { m_position = position; }
+    void setPosition(const sf::Vector2f &position)
+    {
+        m_position = position;
+        m_previousPosition = position;
+        seekWindow();
+    }
     void setScrollSpeed(const sf::Vector2f &scrollSpeed) { m_scrollSpeed = scrollSpeed; }
+    /* How far the arena moved in the last tick */
+    [[nodiscard]] sf::Vector2f getScrollDelta() const { return m_position - m_previousPosition; }
+    [[nodiscard]] ArenaScroll getScroll() const { return {m_position, m_previousPosition}; }
+    /* Picks a run back up where getScroll left it, so one arena can take turns simulating many runs */
+    void setScroll(const ArenaScroll &scroll)
+    {
+        m_position = scroll.position;
+        m_previousPosition = scroll.previousPosition;
+        advanceWindow();
+    }
 
-    void setViewportSize(const sf::Vector2f &viewport) { m_viewportSize = viewport; }
+    void setViewportSize(const sf::Vector2f &viewport)
+    {
+        m_viewportSize = viewport;
+        seekWindow();
+    }
     sf::Vector2f getViewportSize() const { return m_viewportSize; }
 
-    [[nodiscard]] ArenaItem *getObject(uint64_t id);
-
-    [[nodiscard]] ArenaItem *collidePlayer(const sf::FloatRect &shape);
+    [[nodiscard]] const ArenaItem *getObject(uint64_t id) const;
+
+    /* First tile overlapping the shape, which is relative to the arena position, runs its collision callback */
+    [[nodiscard]] std::optional<TileHit> collidePlayer(const sf::FloatRect &shape);
+    /* Appends every tile overlapping the shape to hits, in the order collidePlayer visits them, and returns how many.
+     * No collision callbacks run */
+    size_t collidePlayerAll(const sf::FloatRect &shape, std::vector<TileHit> &hits) const;
+    /* First tile the shape runs into moving by delta. The shape starts relative to the arena position and the delta
+     * is relative to the arena, so steps of any length are resolved at once */
+    [[nodiscard]] std::optional<TileSweep> sweepPlayer(const sf::FloatRect &shape, const sf::Vector2f &delta);
+    /* Cells the shape, relative to the arena position, passes through moving by delta */
+    [[nodiscard]] sf::IntRect getSweepCells(const sf::FloatRect &shape, const sf::Vector2f &delta) const;
+    /* sweepPlayer against tiles collected up front, so many shapes can share one query. candidates has to hold every
+     * tile in the sweep cells that needs a shape test, the others are skipped, and colliders their colliders in the
+     * same order. Nothing is counted and no collision callbacks run, so any number of threads can sweep the same
+     * arena */
+    [[nodiscard]] std::optional<TileSweep> sweepShape(const sf::FloatRect &shape, const sf::Vector2f &delta,
+                                                      std::span<const size_t> candidates,
+                                                      const ColliderBatch &colliders) const;
 
     void resetPos();
+    /* Starts the level over, only touches per-run state so it doesn't depend on the level size */
+    void reset();
 
 #ifndef NDEBUG
     [[nodiscard]] int getCollisionsThisFrame() const { return m_collisions; }
@@ -47,48 +102,45 @@ public:
     [[nodiscard]] int getCollisionsThisFrame() { return 0; }
 #endif // NDEBUG
 private:
-    sf::Vector2i m_size;
+    // Never null, an arena without a level plays an empty one
+    std::shared_ptr<const Level> m_level = std::make_shared<const Level>();
+
     sf::Vector2f m_viewportSize;
     sf::Vector2f m_position;
+    // Where the arena was before the last tick, only used for drawing
+    sf::Vector2f m_previousPosition;
 
     sf::Vector2f m_scrollSpeed;
 
-    std::vector<ArenaItem> m_objects;
-
-    // List of tiles in the arena
-    std::vector<size_t> m_map;
-    sf::Vector2i m_tileSize;
+    // Visible objects are [m_windowFirst, m_windowLast), moves forward with the arena
+    size_t m_windowFirst = 0;
+    size_t m_windowLast = 0;
+    float m_windowLeft = 0;
 
-    // ID to Image
-    std::unordered_map<int, std::shared_ptr<sf::Texture>> m_textures;
+    [[nodiscard]] float getWindowLeft() const;
+    [[nodiscard]] float getWindowRight() const;
+    void advanceWindow();
+    void seekWindow();
 
-    bool parseLayer(const std::string &layer, sf::Vector2i tileSize);
-
-    // Convienience
-    struct Tile
+    // Animation state of the level's animated objects, in the same order
+    struct Animation
     {
-        sf::Vector2i size{};
-        std::string texture;
+        int frame = 0;
+        double timer = 0;
     };
+    std::vector<Animation> m_animations;
 
-    struct TileSet
-    {
-        std::string name;
-        int firstGid{};
-        int tileWidth{};
-        int tileHeight{};
-
-        int tileCount = 0;
-        int columnCount = 0;
-        int padding = 0;
-
-        std::vector<Tile> tiles;
-    };
+    // Scratch for the collision queries, kept so they don't allocate every frame
+    std::vector<size_t> m_candidates;
+    ColliderBatch m_colliders;
 
-    void createWorld(const std::vector<TileSet> &set);
+    // Animated items can't be baked, they are batched every frame instead
+    std::vector<TextureBatch> m_batches;
 
 #ifndef NDEBUG
     size_t m_collisions = 0;
     size_t m_rendered = 0;
+    // Tested against the player this frame, only used to highlight colliders
+    std::vector<size_t> m_tested;
 #endif // NDEBUG
 };
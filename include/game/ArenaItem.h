@@ -9,18 +9,25 @@
 #include <functional>
 #include <memory>
 
-#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 
-#include "Collision.h"
+#include "TileCollider.h"
 
-enum class ArenaItemType
-{
-    Default,
-    Spike,
-    TinySpike,
-};
+// Tiled's flips of a tile packed into a byte
+constexpr uint8_t TILE_FLIPPED_HORIZONTALLY = 1 << 0;
+constexpr uint8_t TILE_FLIPPED_VERTICALLY = 1 << 1;
+constexpr uint8_t TILE_FLIPPED_DIAGONALLY = 1 << 2;
 
+/* Appends two triangles showing textureRect at position, flips are TILE_FLIPPED_* bits */
+void batchTile(sf::VertexArray &vertices, const sf::Vector2f &position, const sf::Vector2f &size,
+               const sf::IntRect &textureRect, uint8_t flips, sf::Color tint);
+/* Draws the collider of a tile at position, only does anything in debug builds */
+void renderTileCollider(ArenaItemType type, int frame, const sf::Vector2f &position, const sf::Vector2f &size,
+                        bool collided);
+
+/* A tile with its own state, only needed for the few tiles that animate or have callbacks */
 class ArenaItem
 {
 public:
@@ -29,12 +36,22 @@ public:
     ~ArenaItem() = default;
 
     void setAnimation(int minFrame, int maxFrame, int frameRate);
-
-    void update();
-    void render(const sf::Vector2f &cameraPos, sf::Color tint);
-
-    void setRelativePosition(const sf::Vector2f &position) { m_relativePosition = position; }
-    sf::Vector2f getRelativePosition() const { return m_relativePosition; }
+    [[nodiscard]] bool isAnimated() const
+    {
+        return m_texFrameCount.x * m_texFrameCount.y > 1 and m_frameRate > 0 and m_minFrame != m_maxFrame;
+    }
+
+    /* Advances an animation by dt seconds, the frame and timer belong to whoever is playing the level */
+    void animate(int &frame, double &timer, float dt) const;
+    /* Appends two triangles showing frame to a batch, offset is added to the item's position */
+    void batch(sf::VertexArray &vertices, const sf::Vector2f &offset, sf::Color tint, int frame) const;
+
+    [[nodiscard]] const sf::Texture *getTexture() const { return m_texture.get(); }
+    [[nodiscard]] sf::IntRect getTextureRect(int frame) const;
+    /* Frame the item was placed with, animations start from it */
+    [[nodiscard]] int getFrame() const { return m_frame; }
+    /* Top left of the first frame, for textures packed into an atlas */
+    void setTextureOrigin(const sf::Vector2i &origin) { m_textureOrigin = origin; }
 
     [[nodiscard]] sf::Vector2f getPosition() const { return m_position; }
     [[nodiscard]] sf::Vector2f getSize() const { return m_size; }
@@ -44,8 +61,8 @@ public:
     void regenCollider();
     void setType(ArenaItemType type);
     [[nodiscard]] ArenaItemType getType() const { return m_type; }
-
-    [[nodiscard]] bool collides(const sf::FloatRect &shape);
+    /* In world space */
+    [[nodiscard]] const Collider &getCollider() const { return m_collider; }
 
     // Callbacks for custom collision and update logic
     std::function<void()> getOnCollision() const { return m_onCollision; }
@@ -60,20 +77,13 @@ public:
 
     static void resetIds();
 
-#ifndef NDEBUG
-    [[nodiscard]] bool getCollidedThisFrame() const { return m_collidedThisFrame; }
-#else
-    [[nodiscard]] bool getCollidedThisFrame() const { return false; }
-#endif // NDEBUG
 private:
     static uint64_t s_idCounter;
     uint64_t m_id = 0;
 
-    sf::Sprite m_sprite;
     std::shared_ptr<sf::Texture> m_texture;
 
     sf::Vector2f m_position;
-    sf::Vector2f m_relativePosition;
     sf::Vector2f m_size;
 
     ArenaItemType m_type{ArenaItemType::Default};
@@ -85,19 +95,14 @@ private:
     int m_minFrame;
     int m_maxFrame;
     int m_frameRate;
-    int m_currentFrame;
+    int m_frame;
     sf::Vector2i m_padding;
-    double m_dtCounter = 0;
+    sf::Vector2i m_textureOrigin{0, 0};
 
     bool m_flippedHorizontally = false;
     bool m_flippedVertically = false;
     bool m_flippedDiagonally = false;
 
-    std::shared_ptr<CollisionBox> m_collision = nullptr;
-
-    void setColliderPos();
-
-#ifndef NDEBUG
-    bool m_collidedThisFrame = false;
-#endif
+    // In world space, queries move the shape instead
+    Collider m_collider;
 };
@@ -0,0 +1,76 @@
+/*
+ * ColliderBatch.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include "game/Collision.h"
+
+/* Many colliders packed into flat arrays so they can be swept several at a time. Every collider is a bounding
+ * box and three edges, rectangles get edges that never separate anything */
+class ColliderBatch
+{
+public:
+    void clear();
+    void reserve(size_t count);
+
+    void add(const RectangleCollider &collider);
+    void add(const TriangleCollider &collider);
+    void add(const Collider &collider);
+
+    [[nodiscard]] size_t size() const { return m_left.size(); }
+    [[nodiscard]] bool empty() const { return m_left.empty(); }
+
+    /* The side of collider a sweep ran into, axis is what sweepBatch reported for it */
+    [[nodiscard]] sf::Vector2f getSweepNormal(size_t collider, uint8_t axis) const;
+
+    // Axes of a sweep: the four sides of the bounding box, then both sides of each edge
+    static constexpr uint8_t BOUNDS_AXES = 4;
+    // Reported when the shape already overlapped the collider, which has no side it ran into
+    static constexpr uint8_t NO_AXIS = 0xff;
+
+private:
+    friend void sweepBatch(const ColliderBatch &, const sf::FloatRect &, const sf::Vector2f &, std::span<float>,
+                           std::span<uint8_t>);
+    friend void sweepBatchScalar(const ColliderBatch &, const sf::FloatRect &, const sf::Vector2f &, std::span<float>,
+                                 std::span<uint8_t>);
+
+    std::vector<float> m_left;
+    std::vector<float> m_top;
+    std::vector<float> m_right;
+    std::vector<float> m_bottom;
+
+    struct Edges
+    {
+        std::vector<float> a;
+        std::vector<float> b;
+        std::vector<float> c;
+        std::vector<float> apex;
+    };
+    std::array<Edges, 3> m_edges;
+
+    void addBounds(const sf::FloatRect &bounds);
+    // Sweeps the colliders from first on one at a time
+    void sweepScalar(const sf::FloatRect &shape, const sf::Vector2f &delta, size_t first, std::span<float> times,
+                     std::span<uint8_t> axes) const;
+};
+
+/* When shape moving by delta starts overlapping each collider, with the same rules and the same results as the
+ * colliders' own sweep. times[i] is in [0, 1) when collider i is hit and infinity when it isn't, axes[i] is the axis
+ * for getSweepNormal. Both have to hold at least batch.size() values */
+void sweepBatch(const ColliderBatch &batch, const sf::FloatRect &shape, const sf::Vector2f &delta,
+                std::span<float> times, std::span<uint8_t> axes);
+/* One collider at a time, used where there is no SIMD and to check the vector paths */
+void sweepBatchScalar(const ColliderBatch &batch, const sf::FloatRect &shape, const sf::Vector2f &delta,
+                      std::span<float> times, std::span<uint8_t> axes);
+
+/* Instruction set sweepBatch was built for */
+[[nodiscard]] const char *getSweepBatchPath();
@@ -5,53 +5,109 @@
  */
 #pragma once
 
+#include <array>
+#include <optional>
+#include <variant>
+
 #include "SFML/Graphics/RectangleShape.hpp"
 #include "SFML/System/Vector2.hpp"
 
-class CollisionBox
+// Colliders are plain values, they are stored inline and never allocated on their own
+
+/* Where a shape moving by some delta first overlaps a collider. time is the fraction of the delta travelled before
+ * they touch and normal faces out of the side that was hit, it is zero when they already overlap */
+struct SweepHit
 {
-public:
-    virtual ~CollisionBox() = default;
-    [[nodiscard]] virtual bool collides(const sf::FloatRect &shape) = 0;
-    virtual void setPosition(const sf::Vector2f &position) = 0;
+    float time = 0;
+    sf::Vector2f normal;
 };
 
-class TriangleCollider final : public CollisionBox
+class TriangleCollider
 {
 public:
+    // a * x + b * y + c is 0 on the edge, positive inside and apex at the opposite point
+    struct Edge
+    {
+        float a = 0;
+        float b = 0;
+        float c = 0;
+        float apex = 0;
+    };
+
     TriangleCollider(const sf::Vector2f &leftPoint, const sf::Vector2f &rightPoint, const sf::Vector2f &topPoint);
-    [[nodiscard]] bool collides(const sf::FloatRect &shape) override;
-    void setPosition(const sf::Vector2f &position) override;
+    /* Exact overlap using the separating axis theorem, shapes that only touch don't collide like sf::Rect */
+    [[nodiscard]] bool collides(const sf::FloatRect &shape) const
+    {
+        const float left = shape.left;
+        const float top = shape.top;
+        const float right = shape.left + shape.width;
+        const float bottom = shape.top + shape.height;
+
+        // The rect's own axes, the triangle's extent on them is its bounding box
+        if (right <= m_bounds.left or left >= m_bounds.left + m_bounds.width or bottom <= m_bounds.top or
+            top >= m_bounds.top + m_bounds.height)
+            return false;
+
+        for (const Edge &edge: m_edges)
+        {
+            // The corners of the rect furthest along and against the edge normal
+            const float high = edge.a * (edge.a > 0 ? right : left) + edge.b * (edge.b > 0 ? bottom : top) + edge.c;
+            const float low = edge.a * (edge.a > 0 ? left : right) + edge.b * (edge.b > 0 ? top : bottom) + edge.c;
+            if (high <= 0 or low >= edge.apex)
+                return false;
+        }
+
+        return true;
+    }
+    /* The shape moving by delta, with the same axes as collides */
+    [[nodiscard]] std::optional<SweepHit> sweep(const sf::FloatRect &shape, const sf::Vector2f &delta) const;
+    void setPosition(const sf::Vector2f &position);
 
     [[nodiscard]] sf::Vector2f getLeftPoint() const { return m_leftPoint; }
     [[nodiscard]] sf::Vector2f getRightPoint() const { return m_rightPoint; }
     [[nodiscard]] sf::Vector2f getTopPoint() const { return m_topPoint; }
+    [[nodiscard]] const std::array<Edge, 3> &getEdges() const { return m_edges; }
+    [[nodiscard]] const sf::FloatRect &getBounds() const { return m_bounds; }
 
 private:
-    [[nodiscard]] bool inside(const sf::Vector2f &point) const;
-
-    float m_leftMinAngle = 0;
-    float m_leftMaxAngle = 0;
-    float m_rightMinAngle = 0;
-    float m_rightMaxAngle = 0;
+    std::array<Edge, 3> m_edges{};
+    sf::FloatRect m_bounds;
 
     sf::Vector2f m_leftPoint;
     sf::Vector2f m_rightPoint;
     sf::Vector2f m_topPoint;
+
+    void buildEdges();
 };
 
-class RectangleCollider final : public CollisionBox
+class RectangleCollider
 {
 public:
     RectangleCollider(const sf::Vector2f &topLeft, const sf::Vector2f &size);
-    [[nodiscard]] bool collides(const sf::FloatRect &shape) override;
+    [[nodiscard]] bool collides(const sf::FloatRect &shape) const { return m_shape.intersects(shape); }
+    [[nodiscard]] std::optional<SweepHit> sweep(const sf::FloatRect &shape, const sf::Vector2f &delta) const;
 
-    void setPosition(const sf::Vector2f &position) override
+    void setPosition(const sf::Vector2f &position)
     {
         m_shape.left = position.x;
         m_shape.top = position.y;
     }
 
+    [[nodiscard]] const sf::FloatRect &getShape() const { return m_shape; }
+
 private:
     sf::FloatRect m_shape;
 };
+
+using Collider = std::variant<RectangleCollider, TriangleCollider>;
+
+[[nodiscard]] inline bool collides(const Collider &collider, const sf::FloatRect &shape)
+{
+    return std::visit([&shape](const auto &value) { return value.collides(shape); }, collider);
+}
+
+[[nodiscard]] inline std::optional<SweepHit> sweep(const Collider &collider, const sf::FloatRect &shape,
+                                                   const sf::Vector2f &delta)
+{
+    return std::visit([&](const auto &value) { return value.sweep(shape, delta); }, collider);
+}
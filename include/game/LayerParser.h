@@ -0,0 +1,27 @@
+/*
+ * LayerParser.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/* Parses the csv data of a tiled layer straight into out without allocating.
+ * count is set to the number of cells read, returns false on malformed or oversized data */
+[[nodiscard]] bool parseCsvLayer(std::string_view csv, std::span<uint32_t> out, size_t &count);
+
+enum class LayerCompression
+{
+    None,
+    Zlib,
+    Gzip,
+    Zstd
+};
+
+/* Decodes base64 layer data, decompressing as it goes, straight into out.
+ * Tiled stores every gid as a little endian 32 bit integer */
+[[nodiscard]] bool parseBase64Layer(std::string_view base64, LayerCompression compression, std::span<uint32_t> out,
+                                    size_t &count);
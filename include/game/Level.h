@@ -0,0 +1,291 @@
+/*
+ * Level.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "TextureAtlas.h"
+#include "game/ArenaItem.h"
+#include "game/ColliderBatch.h"
+#include "game/LevelFile.h"
+
+// Tiles are drawn with one vertex array per texture
+struct TextureBatch
+{
+    const sf::Texture *texture = nullptr;
+    sf::VertexArray vertices{sf::Triangles};
+};
+
+/* A tile something ran into, position is the top left of the tile in world space */
+struct TileHit
+{
+    size_t tile = 0;
+    ArenaItemType type = ArenaItemType::Default;
+    sf::Vector2f position;
+};
+
+/* A tile something moving ran into and when, see SweepHit */
+struct TileSweep
+{
+    TileHit hit;
+    SweepHit sweep;
+};
+
+/* Finds or adds the batch for a texture, levels only have a handful so this is a linear search */
+[[nodiscard]] sf::VertexArray &getTextureBatch(std::vector<TextureBatch> &batches, const sf::Texture *texture);
+
+/* Everything about a level that never changes while it is played. Loaded once by the AssetManager
+ * and shared by every run, the state of a single run lives in Arena. Nothing in it changes after loading, not even
+ * caches, so arenas on any thread can use the same level at once. Anything per run or per draw belongs in Arena */
+class Level
+{
+public:
+    Level() = default;
+    ~Level() = default;
+
+    // Copying would duplicate every item, share the level instead
+    Level(const Level &) = delete;
+    Level &operator=(const Level &) = delete;
+
+    /* sharedTextures are ids of AssetManager textures to pack into the level's atlas. Without graphics no images or
+     * textures are loaded, the level can be simulated but draws nothing */
+    [[nodiscard]] bool loadFromFile(const std::string &filePath, const std::vector<std::string> &sharedTextures = {},
+                                    bool loadGraphics = true);
+    [[nodiscard]] bool hasGraphics() const { return m_hasGraphics; }
+    /* The file the level was loaded from, replays refer to levels by it */
+    [[nodiscard]] const std::string &getFilePath() const { return m_filePath; }
+
+    [[nodiscard]] sf::Vector2i getSize() const { return m_size; }
+    [[nodiscard]] sf::Vector2i getTileSize() const { return m_tileSize; }
+    [[nodiscard]] std::span<const uint32_t> getMap() const { return m_map; }
+    /* Arena position a run starts at */
+    [[nodiscard]] sf::Vector2f getStartPosition() const { return m_startPosition; }
+
+    [[nodiscard]] const TextureAtlas &getAtlas() const { return m_atlas; }
+    /* Where a tile's frame lives in the atlas, flip flags must already be cleared */
+    [[nodiscard]] const AtlasRegion &getTileRegion(uint32_t gid) const;
+
+    // Tiles are sorted by x position so the visible tiles are always a contiguous range
+    [[nodiscard]] size_t getTileCount() const { return m_tileIds.size(); }
+    [[nodiscard]] sf::Vector2f getTilePosition(const size_t tile) const
+    {
+        return {static_cast<float>(m_tileColumns[tile] * m_tileSize.x),
+                static_cast<float>(m_tileRows[tile] * m_tileSize.y)};
+    }
+    [[nodiscard]] sf::Vector2i getTileCell(const size_t tile) const { return {m_tileColumns[tile], m_tileRows[tile]}; }
+    [[nodiscard]] ArenaItemType getTileType(const size_t tile) const { return m_tileTypes[tile]; }
+    [[nodiscard]] uint8_t getTileFlips(const size_t tile) const { return m_tileFlips[tile]; }
+    [[nodiscard]] TileHit getTileHit(const size_t tile) const
+    {
+        return {tile, m_tileTypes[tile], getTilePosition(tile)};
+    }
+    /* Whether a is visited before b, cells are visited bottom to top, then left to right */
+    [[nodiscard]] bool isVisitedBefore(const size_t a, const size_t b) const
+    {
+        if (m_tileRows[a] != m_tileRows[b])
+            return m_tileRows[a] > m_tileRows[b];
+        return m_tileColumns[a] < m_tileColumns[b];
+    }
+    /* Index of the first tile at or right of x */
+    [[nodiscard]] size_t findFirstTile(float x) const;
+    /* Index past the last tile at or left of x */
+    [[nodiscard]] size_t findLastTile(float x) const;
+
+    /* The collider of a tile in world space */
+    [[nodiscard]] Collider getCollider(size_t tile) const;
+    /* Adds the world space collider of a tile to a batch */
+    void addCollider(size_t tile, ColliderBatch &batch) const;
+    /* Runs the collision callback of a tile, for hits found through a batch */
+    void notifyCollision(size_t tile) const;
+    /* Draws the collider of a tile relative to the arena position, only does anything in debug builds */
+    void renderCollider(size_t tile, const sf::Vector2f &cameraPos, const sf::Vector2f &relativePosition,
+                        bool collided) const;
+
+    // Full items for the few tiles that need their own state, in tile order
+    [[nodiscard]] const std::vector<ArenaItem> &getObjects() const { return m_objects; }
+    /* The tile each object was created for */
+    [[nodiscard]] const std::vector<size_t> &getObjectTiles() const { return m_objectTiles; }
+    [[nodiscard]] const std::vector<size_t> &getAnimatedObjects() const { return m_animatedObjects; }
+
+    /* Cells the shape, given relative to offset, could overlap. A solid block in one of them always overlaps it */
+    [[nodiscard]] sf::IntRect getCellRange(const sf::FloatRect &shape, const sf::Vector2f &offset) const;
+
+    /* Calls callback with the index of every tile in cells that needs a shape test, like spikes, until it returns
+     * false. Tiles are visited bottom to top, then left to right */
+    template<typename Callback>
+    void forEachCandidate(const sf::IntRect &cells, Callback &&callback) const;
+
+    // Solid blocks are merged into rectangles of cells for collision, the tiles are still drawn one by one
+    [[nodiscard]] const std::vector<sf::IntRect> &getSolidRects() const { return m_solidRects; }
+    /* The solid block in cells a shape moving by delta, both in world space, runs into first. Ties go to the block
+     * that would be visited first */
+    [[nodiscard]] std::optional<TileSweep> sweepSolid(const sf::IntRect &cells, const sf::FloatRect &shape,
+                                                      const sf::Vector2f &delta) const;
+    /* Calls callback with the index of every solid block in cells, one merged rectangle at a time */
+    template<typename Callback>
+    void forEachSolid(const sf::IntRect &cells, Callback &&callback) const;
+
+    /* Draws the baked static tiles between left and right in world space, returns the number of tiles drawn. They are
+     * baked white, a tint has to come from states.shader */
+    size_t renderStatic(float left, float right, const sf::RenderStates &states) const;
+
+private:
+    std::shared_ptr<const LevelData> m_data;
+    std::string m_filePath;
+    sf::Vector2i m_size{0, 0};
+    sf::Vector2i m_tileSize{0, 0};
+    std::span<const uint32_t> m_map;
+    sf::Vector2f m_startPosition{0, 0};
+    bool m_hasGraphics = false;
+
+    // Every tile is only a few bytes spread over these arrays, one entry per tile
+    std::vector<uint16_t> m_tileColumns;
+    std::vector<uint16_t> m_tileRows;
+    // gid with the flip flags cleared
+    std::vector<uint16_t> m_tileIds;
+    std::vector<ArenaItemType> m_tileTypes;
+    std::vector<uint8_t> m_tileFlips;
+
+    std::vector<ArenaItem> m_objects;
+    std::vector<size_t> m_objectTiles;
+    std::vector<size_t> m_animatedObjects;
+
+    [[nodiscard]] const ArenaItem *findObject(size_t tile) const;
+
+    // Tile aligned grid of tile indices, EMPTY_CELL where there is no tile
+    static constexpr int32_t EMPTY_CELL = -1;
+    std::vector<int32_t> m_grid;
+
+    // One bit per cell with rows padded to whole words for the tiles that need a shape test
+    size_t m_rowWords = 0;
+    std::vector<uint64_t> m_shapeCells;
+
+    // Solid blocks greedily merged into rectangles of cells. Each bucket of SOLID_BUCKET_COLUMNS columns lists the
+    // rectangles reaching into it, m_solidBuckets[b] to m_solidBuckets[b + 1] in m_solidBucketRects
+    static constexpr int SOLID_BUCKET_COLUMNS = 64;
+    std::vector<sf::IntRect> m_solidRects;
+    std::vector<uint32_t> m_solidBuckets;
+    std::vector<uint32_t> m_solidBucketRects;
+
+    void buildGrid();
+    void buildSolidRects(std::vector<uint64_t> solid);
+    /* Calls callback with every solid rectangle overlapping cells and the part of it inside them */
+    template<typename Callback>
+    void forEachSolidRect(const sf::IntRect &cells, Callback &&callback) const;
+
+    // Every tileset image of the level packed into as few textures as possible
+    TextureAtlas m_atlas;
+
+    // Everything known about a gid, indexed by gid with the flip flags cleared
+    static constexpr int NO_TILE_SET = -1;
+    struct TileInfo
+    {
+        int tileSet = NO_TILE_SET;
+        ArenaItemType type = ArenaItemType::Default;
+        int frame = 0;
+        AtlasRegion region{};
+        // Tile sets don't describe animations yet, a tile only gets an ArenaItem once they do
+        int minFrame = 0;
+        int maxFrame = 0;
+        int frameRate = 0;
+    };
+    std::vector<TileInfo> m_tiles;
+
+    // Static tiles never move, so they are baked in world space once and drawn through a transform
+    static constexpr int CHUNK_COLUMNS = 32;
+    struct Chunk
+    {
+        std::vector<TextureBatch> batches;
+        size_t tiles = 0;
+    };
+    std::vector<Chunk> m_chunks;
+
+    void buildChunks();
+
+    [[nodiscard]] bool loadAtlas(const std::string &filePath, const std::vector<TileSet> &tileSets,
+                                 const std::vector<std::string> &sharedTextures);
+    void createWorld(const std::vector<TileSet> &set);
+    void buildTileTable(const std::vector<TileSet> &set);
+    void findStartPosition();
+};
+
+template<typename Callback>
+void Level::forEachCandidate(const sf::IntRect &cells, Callback &&callback) const
+{
+    if (m_shapeCells.empty() or cells.width <= 0 or cells.height <= 0)
+        return;
+
+    const int first = cells.left;
+    const int last = cells.left + cells.width - 1;
+
+    // Walk bottom to top like the tiles were always tested so the first hit stays the same
+    for (int r = cells.top + cells.height - 1; r >= cells.top; --r)
+    {
+        const uint64_t *row = &m_shapeCells[r * m_rowWords];
+        for (int w = first / 64; w <= last / 64; ++w)
+        {
+            uint64_t word = row[w];
+            if (w == first / 64)
+                word &= ~uint64_t{0} << (first % 64);
+            if (w == last / 64)
+                word &= ~uint64_t{0} >> (63 - last % 64);
+
+            for (; word != 0; word &= word - 1)
+            {
+                const int c = w * 64 + std::countr_zero(word);
+                if (!callback(static_cast<size_t>(m_grid[r * m_size.x + c])))
+                    return;
+            }
+        }
+    }
+}
+
+template<typename Callback>
+void Level::forEachSolidRect(const sf::IntRect &cells, Callback &&callback) const
+{
+    if (m_solidBuckets.empty() or cells.width <= 0 or cells.height <= 0)
+        return;
+
+    const int firstBucket = cells.left / SOLID_BUCKET_COLUMNS;
+    const int lastBucket = (cells.left + cells.width - 1) / SOLID_BUCKET_COLUMNS;
+    for (int b = firstBucket; b <= lastBucket; ++b)
+    {
+        for (uint32_t i = m_solidBuckets[b]; i < m_solidBuckets[b + 1]; ++i)
+        {
+            const sf::IntRect &rect = m_solidRects[m_solidBucketRects[i]];
+            sf::IntRect overlap;
+            // Rectangles spanning several buckets are only reported from the first one the cells share
+            if (!rect.intersects(cells, overlap) or overlap.left / SOLID_BUCKET_COLUMNS != b)
+                continue;
+
+            callback(rect, overlap);
+        }
+    }
+}
+
+template<typename Callback>
+void Level::forEachSolid(const sf::IntRect &cells, Callback &&callback) const
+{
+    forEachSolidRect(cells,
+                     [&](const sf::IntRect &, const sf::IntRect &overlap)
+                     {
+                         for (int r = overlap.top; r < overlap.top + overlap.height; ++r)
+                         {
+                             for (int c = overlap.left; c < overlap.left + overlap.width; ++c)
+                                 callback(static_cast<size_t>(m_grid[r * m_size.x + c]));
+                         }
+                     });
+}
@@ -0,0 +1,82 @@
+/*
+ * LevelFile.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+#include "game/LayerParser.h"
+#include "SFML/System/Vector2.hpp"
+
+struct TileSetImage
+{
+    sf::Vector2i size{};
+    std::string texture;
+};
+
+struct TileSet
+{
+    std::string name;
+    int firstGid{};
+    int tileWidth{};
+    int tileHeight{};
+
+    int tileCount = 0;
+    int columnCount = 0;
+    int padding = 0;
+
+    // Paths are relative to the level file
+    std::vector<TileSetImage> tiles;
+};
+
+/* The contents of a level, read from a tiled map or from the compiled binary version of one */
+class LevelData
+{
+public:
+    static constexpr const char *COMPILED_EXTENSION = ".gdl";
+
+    LevelData() = default;
+    ~LevelData() = default;
+
+    // The map may point into a mapped file, so a level can't be copied
+    LevelData(const LevelData &) = delete;
+    LevelData &operator=(const LevelData &) = delete;
+
+    /* Loads the compiled file next to filePath when it is up to date, otherwise parses the tiled map */
+    [[nodiscard]] bool loadFromFile(const std::string &filePath);
+    [[nodiscard]] bool loadFromTmx(const std::string &filePath);
+    /* Rejects the file if sourcePath is given and it changed after compiling */
+    [[nodiscard]] bool loadCompiled(const std::string &filePath, const std::string &sourcePath = "");
+
+    [[nodiscard]] bool saveCompiled(const std::string &filePath, const std::string &sourcePath) const;
+
+    [[nodiscard]] static std::string getCompiledPath(const std::string &filePath);
+
+    [[nodiscard]] sf::Vector2i getSize() const { return m_size; }
+    [[nodiscard]] sf::Vector2i getTileSize() const { return m_tileSize; }
+    [[nodiscard]] const std::vector<TileSet> &getTileSets() const { return m_tileSets; }
+    [[nodiscard]] std::span<const uint32_t> getMap() const { return m_map; }
+    [[nodiscard]] bool isCompiled() const { return m_file.isOpen(); }
+
+private:
+    sf::Vector2i m_size{0, 0};
+    sf::Vector2i m_tileSize{0, 0};
+    std::vector<TileSet> m_tileSets;
+
+    // Points into either m_file or m_parsedMap
+    std::span<const uint32_t> m_map;
+    std::vector<uint32_t> m_parsedMap;
+    MappedFile m_file;
+
+    /* Csv without a compression, base64 with one */
+    bool parseLayer(std::string_view layer, std::optional<LayerCompression> compression = std::nullopt);
+    void reset();
+};
@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include <optional>
+
 #include "SFML/Graphics/Sprite.hpp"
 #include "SFML/Graphics/Texture.hpp"
 #include "SFML/Window/Event.hpp"
@@ -31,14 +33,19 @@ public:
     {
     }
     PlayerAnimator() = default;
-    void update();
+    void update(float dt);
     [[nodiscard]] sf::IntRect &render();
+    /* Back to the first frame */
+    void reset();
 
     [[nodiscard]] sf::Vector2i getSize() const { return m_size; }
     [[nodiscard]] int getMinFrame() const { return m_minFrame; }
     [[nodiscard]] int getMaxFrame() const { return m_maxFrame; }
     [[nodiscard]] int getFrameRate() const { return m_frameRate; }
 
+    /* Top left of the first frame, for textures packed into an atlas */
+    void setOrigin(const sf::Vector2i &origin) { m_origin = origin; }
+
 private:
     sf::IntRect m_rect{};
     double m_dtCounter = 0;
@@ -50,38 +57,62 @@ private:
     int m_frameRate = 0;
     int m_currentFrame = 0;
     sf::Vector2i m_padding{};
+    sf::Vector2i m_origin{};
 };
 
 class Player
 {
 public:
     Player() = default;
+    /* A player without a texture, only for simulating */
+    Player(const sf::Vector2f &position, const sf::Vector2f &size, const PlayerAnimator &animator);
     Player(const sf::Texture &texture, const sf::Vector2f &position, const sf::Vector2f &size,
            const PlayerAnimator &animator);
     ~Player() = default;
 
-    void update(Arena &arena);
-    void render(const sf::Vector2f &cameraPos);
+    /* Advances the player by one simulation tick of dt seconds */
+    void update(Arena &arena, float dt);
+    /* alpha is how far from the previous tick to the latest one the player is drawn */
+    void render(const sf::Vector2f &cameraPos, float alpha = 1);
+    /* Puts the player back where it was created, without touching the texture */
+    void reset();
 
     [[nodiscard]] sf::Vector2f getPosition() const { return m_position; }
+    /* Position between the previous tick and the latest one */
+    [[nodiscard]] sf::Vector2f getInterpolatedPosition(float alpha) const;
     [[nodiscard]] sf::Vector2f getSize() const { return m_size; }
 
     [[nodiscard]] PlayerAnimator &getAnimator() { return m_animator; }
 
-    [[nodiscard]] sf::FloatRect getBounds() const { return m_sprite.getGlobalBounds(); }
+    /* Collision box, it doesn't depend on how or whether the sprite is drawn */
+    [[nodiscard]] sf::FloatRect getBounds() const { return {m_position, m_size}; }
 
     [[nodiscard]] bool isDead() const { return m_isDead; }
+    [[nodiscard]] bool isOnGround() const { return m_onGround; }
+    [[nodiscard]] float getVelocity() const { return m_velocity; }
+    [[nodiscard]] float getAcceleration() const { return m_acceleration; }
+    [[nodiscard]] bool isHoldingJump() const { return m_holdingJump; }
+    /* Seconds a jump pressed in the air is still taken once the player lands */
+    [[nodiscard]] double getHoldJumpLength() const { return m_holdJumpLength; }
 
     void handleEvent(const sf::Event &event);
+    /* Whether event presses (true) or releases (false) jump, nothing for any other event */
+    [[nodiscard]] static std::optional<bool> getJumpInput(const sf::Event &event);
+    // All input goes through these, live events and replays alike
+    void pressJump();
+    void releaseJump();
 
 private:
     bool m_isDead = false;
     bool m_onGround = false;
 
+    // The texture is owned by whoever created the player
     sf::Sprite m_sprite{};
-    sf::Texture m_texture{};
 
     sf::Vector2f m_position{0, 0};
+    // Where the player was before the last tick, only used for drawing
+    sf::Vector2f m_previousPosition{0, 0};
+    sf::Vector2f m_spawnPosition{0, 0};
     sf::Vector2f m_size{64, 64};
 
     // float m_rotation = 0;
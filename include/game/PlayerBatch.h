@@ -0,0 +1,67 @@
+/*
+ * PlayerBatch.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "game/Arena.h"
+
+/* Many independent players running through the same arena, for tuning and training. Each field is its own array so
+ * the physics runs over all players at once, and the tiles around the players are looked up once per tick for all of
+ * them. Every player moves exactly like Player::update would move it, which stays the reference. Players aren't drawn
+ * or animated and don't run collision callbacks */
+class PlayerBatch
+{
+public:
+    PlayerBatch() = default;
+    PlayerBatch(size_t count, const sf::Vector2f &position, const sf::Vector2f &size);
+
+    /* Every player back where the batch was created */
+    void reset();
+
+    /* Advances players [first, last) by one simulation tick of dt seconds, the arena has to be updated for the tick
+     * first like for Player::update. Only reads the arena, so threads can advance separate ranges at once */
+    void update(const Arena &arena, float dt, size_t first, size_t last);
+    void update(const Arena &arena, const float dt) { update(arena, dt, 0, size()); }
+
+    /* Called from every thread before every tick with the players it runs and the tick about to be simulated,
+     * counted from the start of the simulation */
+    using Input = std::function<void(PlayerBatch &batch, size_t first, size_t last, uint32_t tick)>;
+    /* Runs ticks ticks with the players split evenly over threads. Each thread plays its own copy of arena, the
+     * caller's arena is advanced the same way at the end */
+    void simulate(Arena &arena, float dt, uint32_t ticks, unsigned threads, const Input &input = {});
+
+    [[nodiscard]] size_t size() const { return m_y.size(); }
+    /* Players that haven't died, falling out of the level isn't checked like for Player */
+    [[nodiscard]] size_t getAliveCount() const;
+
+    [[nodiscard]] sf::Vector2f getPosition(const size_t player) const { return {m_x, m_y[player]}; }
+    [[nodiscard]] sf::Vector2f getSize() const { return m_size; }
+    [[nodiscard]] float getVelocity(const size_t player) const { return m_velocity[player]; }
+    [[nodiscard]] float getAcceleration(const size_t player) const { return m_acceleration[player]; }
+    [[nodiscard]] bool isOnGround(const size_t player) const { return m_onGround[player] != 0; }
+    [[nodiscard]] bool isDead(const size_t player) const { return m_dead[player] != 0; }
+
+    void pressJump(size_t player);
+    void releaseJump(const size_t player) { m_holdingJump[player] = 0; }
+
+private:
+    // Nothing moves players sideways, they all share the x they were created at
+    float m_x = 0;
+    sf::Vector2f m_spawnPosition{0, 0};
+    sf::Vector2f m_size{0, 0};
+
+    std::vector<float> m_y;
+    std::vector<float> m_velocity;
+    std::vector<float> m_acceleration;
+    std::vector<double> m_holdJumpLength;
+    // Bytes rather than std::vector<bool> so threads can write neighbouring players
+    std::vector<uint8_t> m_onGround;
+    std::vector<uint8_t> m_dead;
+    std::vector<uint8_t> m_holdingJump;
+};
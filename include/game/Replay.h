@@ -0,0 +1,68 @@
+/*
+ * Replay.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game/Player.h"
+
+/* A jump press or release, applied right before the tick it is stamped with is simulated */
+struct ReplayEvent
+{
+    uint32_t tick = 0;
+    bool pressed = false;
+};
+
+/* The input of a single run. The simulation only depends on the level, the tick rate and the jumps, so playing the
+ * events back at the same rate gives the same run every time */
+class Replay
+{
+public:
+    static constexpr int VERSION = 1;
+
+    Replay() = default;
+    /* level is the path of the level file, the same one the level was loaded from */
+    Replay(std::string level, int tickRate);
+
+    /* Events have to be recorded in tick order */
+    void record(uint32_t tick, bool pressed);
+    /* The run ended after ticks ticks */
+    void finish(const uint32_t ticks) { m_ticks = ticks; }
+    /* Forgets the events, keeps the level and tick rate for the next run */
+    void clear();
+
+    [[nodiscard]] bool loadFromFile(const std::string &filePath);
+    [[nodiscard]] bool saveToFile(const std::string &filePath) const;
+
+    [[nodiscard]] const std::string &getLevel() const { return m_level; }
+    [[nodiscard]] int getTickRate() const { return m_tickRate; }
+    [[nodiscard]] uint32_t getTicks() const { return m_ticks; }
+    [[nodiscard]] const std::vector<ReplayEvent> &getEvents() const { return m_events; }
+
+private:
+    std::string m_level;
+    int m_tickRate = 0;
+    uint32_t m_ticks = 0;
+    std::vector<ReplayEvent> m_events;
+};
+
+/* Feeds the jumps of a replay into a player in place of live input */
+class ReplayPlayback
+{
+public:
+    explicit ReplayPlayback(const Replay &replay) : m_replay(&replay) {}
+
+    /* Applies every event stamped with tick, ticks have to be played in order from 0 */
+    void apply(uint32_t tick, Player &player);
+    /* Back to the start for another run */
+    void rewind() { m_next = 0; }
+
+private:
+    const Replay *m_replay;
+    size_t m_next = 0;
+};
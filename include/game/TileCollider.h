@@ -0,0 +1,127 @@
+/*
+ * TileCollider.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include <cstdint>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "Collision.h"
+
+enum class ArenaItemType : uint8_t
+{
+    Default,
+    Spike,
+    TinySpike,
+};
+
+// The frame of a spike decides which way it points
+enum class TileDirection
+{
+    Left,
+    Right,
+    Up,
+    Down
+};
+
+constexpr TileDirection getTileDirection(const int frame)
+{
+    switch (frame)
+    {
+        case 1:
+            return TileDirection::Down;
+        case 2:
+            return TileDirection::Left;
+        case 3:
+            return TileDirection::Right;
+        default:
+            return TileDirection::Up;
+    }
+}
+
+/* Builds the collider of a tile in world space, there is one per type so the tests inline */
+template<ArenaItemType Type>
+struct TileCollider
+{
+    // Anything that isn't a spike is a solid block
+    static RectangleCollider make(int, const sf::Vector2f &position, const sf::Vector2f &size)
+    {
+        return {position, size};
+    }
+};
+
+template<>
+struct TileCollider<ArenaItemType::Spike>
+{
+    static TriangleCollider make(const int frame, const sf::Vector2f &position, const sf::Vector2f &size)
+    {
+        switch (getTileDirection(frame))
+        {
+            case TileDirection::Left:
+                return {sf::Vector2f(position.x, position.y + (size.y / 2)),
+                        sf::Vector2f(position.x + size.x, position.y + size.y),
+                        sf::Vector2f(position.x + size.x, position.y)};
+            case TileDirection::Right:
+                return {sf::Vector2f(position.x, position.y + size.y),
+                        sf::Vector2f(position.x + size.x, position.y + (size.y / 2)),
+                        sf::Vector2f(position.x, position.y)};
+            case TileDirection::Down:
+                return {sf::Vector2f(position.x, position.y),
+                        sf::Vector2f(position.x + (size.x / 2), position.y + size.y),
+                        sf::Vector2f(position.x + size.x, position.y)};
+            case TileDirection::Up:
+            default:
+                return {sf::Vector2f(position.x, position.y + size.y),
+                        sf::Vector2f(position.x + size.x, position.y + size.y),
+                        sf::Vector2f(position.x + (size.x / 2), position.y)};
+        }
+    }
+};
+
+template<>
+struct TileCollider<ArenaItemType::TinySpike>
+{
+    // Half the height of a spike, sitting on the same edge
+    static TriangleCollider make(const int frame, const sf::Vector2f &position, const sf::Vector2f &size)
+    {
+        switch (getTileDirection(frame))
+        {
+            case TileDirection::Left:
+                return {sf::Vector2f(position.x + (size.x / 2), position.y + (size.y / 2)),
+                        sf::Vector2f(position.x + size.x, position.y + size.y),
+                        sf::Vector2f(position.x + size.x, position.y)};
+            case TileDirection::Right:
+                return {sf::Vector2f(position.x, position.y + size.y),
+                        sf::Vector2f(position.x + (size.x / 2), position.y + (size.y / 2)),
+                        sf::Vector2f(position.x, position.y)};
+            case TileDirection::Down:
+                return {sf::Vector2f(position.x, position.y), sf::Vector2f(position.x + size.x, position.y),
+                        sf::Vector2f(position.x + (size.x / 2), position.y + (size.y / 2))};
+            case TileDirection::Up:
+            default:
+                return {sf::Vector2f(position.x, position.y + size.y),
+                        sf::Vector2f(position.x + size.x, position.y + size.y),
+                        sf::Vector2f(position.x + (size.x / 2), position.y + (size.y / 2))};
+        }
+    }
+};
+
+/* Stored collider of a tile, for items that keep theirs */
+[[nodiscard]] inline Collider makeTileCollider(const ArenaItemType type, const int frame, const sf::Vector2f &position,
+                                               const sf::Vector2f &size)
+{
+    switch (type)
+    {
+        case ArenaItemType::Spike:
+            return TileCollider<ArenaItemType::Spike>::make(frame, position, size);
+        case ArenaItemType::TinySpike:
+            return TileCollider<ArenaItemType::TinySpike>::make(frame, position, size);
+        case ArenaItemType::Default:
+        default:
+            return TileCollider<ArenaItemType::Default>::make(frame, position, size);
+    }
+}
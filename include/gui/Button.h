@@ -83,6 +83,7 @@ public:
 
     void setTexture(const sf::Texture &texture) { m_sprite.setTexture(texture); }
     const sf::Texture *getTexture() const { return m_sprite.getTexture(); }
+    void setTextureRect(const sf::IntRect &rect) { m_sprite.setTextureRect(rect); }
 
     void update();
     void render();
@@ -0,0 +1,32 @@
+/*
+ * ProfilerOverlay.h
+ * @author Matthew Brown
+ * @date 10/17/2026
+ */
+#pragma once
+
+#include "SFML/Graphics/Font.hpp"
+#include "SFML/Graphics/Text.hpp"
+#include "gui/Panel.h"
+
+/* Where the frames go according to the profiler, drawn over everything else while it is enabled */
+class ProfilerOverlay
+{
+public:
+    ProfilerOverlay() = default;
+
+    /* Needs the window, so it can't happen before the game runs */
+    void create();
+    /* Picks up the latest frame stats every so often, dt is the real time the frame took */
+    void update(float dt);
+    void render();
+
+private:
+    sf::Font m_font;
+    sf::Text m_text;
+    Panel m_background;
+
+    float m_sinceRefresh = 0;
+    // Faster than this the numbers can't be read
+    static constexpr float REFRESH_TIME = 0.25f;
+};
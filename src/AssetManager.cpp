@@ -71,9 +71,12 @@ sf::Color fromHSL(const float h, const float s, const float l)
             static_cast<sf::Uint8>((p.b + m) * 255)};
 }
 
-AssetManager AssetManager::S_instance{};
-
-AssetManager &AssetManager::getInstance() { return AssetManager::S_instance; }
+AssetManager &AssetManager::getInstance()
+{
+    // Only created once something asks for it, the default texture needs a graphics context
+    static AssetManager instance;
+    return instance;
+}
 
 bool AssetManager::loadTexture(const std::string &filePath, const std::string &id)
 {
@@ -138,9 +141,10 @@ sf::Font &AssetManager::getFont(const std::string &id)
     return m_fonts[id];
 }
 
-bool AssetManager::loadLevel(const std::string &filePath, const std::string &id)
+bool AssetManager::loadLevel(const std::string &filePath, const std::string &id,
+                             const std::vector<std::string> &sharedTextures)
 {
-    if (m_arenas.contains(id))
+    if (m_levels.contains(id))
     {
         // Already loaded, don't waste your time
         SL_LOGF_DEBUG("Attempted to reload level with id <{}>", id);
@@ -148,30 +152,30 @@ bool AssetManager::loadLevel(const std::string &filePath, const std::string &id)
     }
     SL_LOGF_INFO("Loading level <{}> with id: {}", filePath, id);
 
-    Arena arena;
-    if (!arena.loadFromFile(filePath))
+    auto level = std::make_shared<Level>();
+    if (!level->loadFromFile(filePath, sharedTextures))
     {
         SL_LOGF_ERROR("Failed to load level <{}> with id {}", filePath, id);
         return false;
     }
 
-    m_arenas[id] = arena;
+    m_levels[id] = level;
     return true;
 }
 
-Arena &AssetManager::getLevel(const std::string &id)
+std::shared_ptr<const Level> AssetManager::getLevel(const std::string &id)
 {
-    if (!m_arenas.contains(id))
+    if (!m_levels.contains(id))
     {
-        return m_defaultArena;
+        return m_defaultLevel;
     }
 
-    return m_arenas[id];
+    return m_levels[id];
 }
 
 void AssetManager::clean()
 {
     m_textures.clear();
     m_fonts.clear();
-    m_arenas.clear();
+    m_levels.clear();
 }
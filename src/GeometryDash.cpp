@@ -1,17 +1,19 @@
 /* Created by Matthew Brown on 6/19/2024 */
 
+#include <algorithm>
 #include <filesystem>
 #include <format>
 
 #include "GeometryDash.h"
+#include "Profiler.h"
 #include "simplelogger.hpp"
 
 #include "tinyxml2.h"
 
-GeometryDash GeometryDash::S_instance{};
 bool GeometryDash::RenderCollisionShapes = false;
 bool GeometryDash::EnableVSync = true;
 bool GeometryDash::Restart = false;
+int GeometryDash::SimTickRate = 240;
 
 #ifndef NDEBUG
 bool GeometryDash::EnableDebug = true;
@@ -20,12 +22,23 @@ bool GeometryDash::EnableDebug = true;
 bool GeometryDash::EnableDebug = false;
 #endif // NDEBUG
 
-GeometryDash &GeometryDash::getInstance() { return S_instance; }
+GeometryDash &GeometryDash::getInstance()
+{
+    // Only created once something asks for it, the window it owns needs a display
+    static GeometryDash instance;
+    return instance;
+}
 
 void GeometryDash::Reset()
 {
     SL_LOG_INFO("Resetting GeometryDash");
-    S_instance.getWindow().destroy();
+    getInstance().getWindow().destroy();
+}
+
+void GeometryDash::SetTickRate(const int rate)
+{
+    SimTickRate = std::clamp(rate, MIN_TICK_RATE, MAX_TICK_RATE);
+    getInstance().m_tickTime = sf::seconds(1.0f / static_cast<float>(SimTickRate));
 }
 
 void GeometryDash::changeState(const std::shared_ptr<State> &state) noexcept(false)
@@ -63,9 +76,12 @@ void GeometryDash::LoadSettings()
     EnableVSync = root->BoolAttribute("EnableVSync");
     EnableDebug = root->BoolAttribute("EnableDebug");
     RenderCollisionShapes = root->BoolAttribute("EnableCollisionShapes");
+    SetTickRate(root->IntAttribute("SimTickRate", SimTickRate));
+    Profiler::SetEnabled(root->BoolAttribute("EnableProfiler"));
 
-    SL_LOGF_DEBUG("Settings loaded: EnableVSync={}, EnableDebug={}, EnableCollisionShapes={}", EnableVSync, EnableDebug,
-                  RenderCollisionShapes);
+    SL_LOGF_DEBUG("Settings loaded: EnableVSync={}, EnableDebug={}, EnableCollisionShapes={}, SimTickRate={}, "
+                  "EnableProfiler={}",
+                  EnableVSync, EnableDebug, RenderCollisionShapes, SimTickRate, Profiler::IsEnabled());
 }
 
 void GeometryDash::SaveSettings()
@@ -80,12 +96,30 @@ void GeometryDash::SaveSettings()
     root->SetAttribute("EnableVSync", EnableVSync);
     root->SetAttribute("EnableDebug", EnableDebug);
     root->SetAttribute("EnableCollisionShapes", RenderCollisionShapes);
+    root->SetAttribute("SimTickRate", SimTickRate);
+    root->SetAttribute("EnableProfiler", Profiler::IsEnabled());
 
     // Actually save the settings
     if (const tinyxml2::XMLError error = doc.SaveFile("settings.xml"); error != tinyxml2::XML_SUCCESS)
         SL_LOGF_ERROR("Failed to save settings.xml: {}", doc.ErrorIDToName(error));
 }
 
+void GeometryDash::handleProfilerEvent(const sf::Event &event)
+{
+    if (event.type != sf::Event::KeyPressed)
+        return;
+
+    if (event.key.code == sf::Keyboard::F3)
+    {
+        Profiler::SetEnabled(!Profiler::IsEnabled());
+    }
+    else if (event.key.code == sf::Keyboard::F4 and Profiler::IsEnabled())
+    {
+        // Whatever the ring buffers still hold, the last few seconds
+        Profiler::getInstance().saveChromeTrace(PROFILER_TRACE_PATH);
+    }
+}
+
 bool GeometryDash::run() noexcept(false)
 {
     SL_LOG_INFO("Starting GeometryDash");
@@ -98,36 +132,72 @@ bool GeometryDash::run() noexcept(false)
 
     m_window.getWindow().setFramerateLimit(120);
 
+    SetTickRate(SimTickRate);
+    SL_LOGF_DEBUG("Simulating at {} ticks per second", SimTickRate);
+
+    m_profilerOverlay.create();
+
+    sf::Time accumulator = sf::Time::Zero;
+    m_clock.restart();
     while (m_state and m_window.isOpen())
     {
         m_deltaTime = m_clock.restart();
+        // A hitch only delays the simulation, it never makes a tick longer
+        accumulator += std::min(m_deltaTime, sf::seconds(MAX_FRAME_TIME));
 
         // Event handling
-        sf::Event event{};
-        while (m_window.getWindow().pollEvent(event))
         {
-            if (event.type == sf::Event::Closed and !m_state->handleCloseEvent())
+            ProfileZone zone("Events");
+            sf::Event event{};
+            while (m_window.getWindow().pollEvent(event))
             {
-                m_window.close();
-                break;
+                if (event.type == sf::Event::Closed and !m_state->handleCloseEvent())
+                {
+                    m_window.close();
+                    break;
+                }
+
+                handleProfilerEvent(event);
+                m_state->handleEvent(event);
             }
+        }
 
-            m_state->handleEvent(event);
+        {
+            ProfileZone zone("State::tick");
+            while (accumulator >= m_tickTime and m_state)
+            {
+                m_state->tick();
+                accumulator -= m_tickTime;
+            }
         }
+        m_interpolation = accumulator / m_tickTime;
 
-        m_state->update();
+        {
+            ProfileZone zone("State::update");
+            m_state->update();
+        }
         if (m_state->quit()) // Should the program quit? (no need to render if so)
         {
             m_window.close();
             break;
         }
+        m_profilerOverlay.update(m_deltaTime.asSeconds());
 
         // Render the screen
         m_window.clear();
 
-        m_state->render();
+        {
+            ProfileZone zone("State::render");
+            m_state->render();
+        }
+        m_profilerOverlay.render();
+
+        {
+            ProfileZone zone("Window::render");
+            m_window.render();
+        }
 
-        m_window.render();
+        Profiler::getInstance().endFrame();
     }
 
     SL_LOG_INFO("Exiting GeometryDash");
@@ -5,6 +5,7 @@
 #include "OptionsState.h"
 #include "PlayState.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "AssetManager.h"
@@ -65,9 +66,9 @@ MainMenuState::MainMenuState()
 void MainMenuState::update()
 {
     // Update the menu
-    m_avgFPS = static_cast<int>(std::floor(1000 / GeometryDash::getInstance().getDeltaTime().asMilliseconds()) +
-                                static_cast<float>(m_avgFPS)) /
-               2;
+    // Frames can take less than a millisecond, keep the fraction
+    const float frameTime = std::max(GeometryDash::getInstance().getDeltaTime().asSeconds(), 1e-6f);
+    m_avgFPS = static_cast<int>((std::floor(1 / frameTime) + static_cast<float>(m_avgFPS)) / 2);
     if (m_updateCount > 0.25)
     {
         m_updateCount = 0.0;
@@ -0,0 +1,147 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "MappedFile.h"
+
+#include <format>
+#include <utility>
+
+#include "simplelogger.hpp"
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef WIN32
+        m_file = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif // WIN32
+    }
+
+    return *this;
+}
+
+#ifdef WIN32
+
+bool MappedFile::open(const std::string &filePath)
+{
+    close();
+
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        SL_LOGF_ERROR("Failed to open <{}> for mapping", filePath);
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) or size.QuadPart == 0)
+    {
+        SL_LOGF_ERROR("Failed to get the size of <{}> or it is empty", filePath);
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        SL_LOGF_ERROR("Failed to create a mapping of <{}>", filePath);
+        CloseHandle(file);
+        return false;
+    }
+
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        SL_LOGF_ERROR("Failed to map <{}>", filePath);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = static_cast<const std::byte *>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if (m_file != nullptr)
+        CloseHandle(m_file);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_file = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string &filePath)
+{
+    close();
+
+    const int file = ::open(filePath.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        SL_LOGF_ERROR("Failed to open <{}> for mapping", filePath);
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(file, &info) != 0 or info.st_size == 0)
+    {
+        SL_LOGF_ERROR("Failed to get the size of <{}> or it is empty", filePath);
+        ::close(file);
+        return false;
+    }
+
+    void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping keeps its own reference to the file
+    ::close(file);
+    if (data == MAP_FAILED)
+    {
+        SL_LOGF_ERROR("Failed to map <{}>", filePath);
+        return false;
+    }
+
+    m_data = static_cast<const std::byte *>(data);
+    m_size = static_cast<size_t>(info.st_size);
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data != nullptr)
+        munmap(const_cast<std::byte *>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif // WIN32
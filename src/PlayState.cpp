@@ -5,10 +5,12 @@
 #include "game/SettingsState.h"
 #include "simplelogger.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <format>
 #include <random>
+#include <utility>
 
 #include "AssetManager.h"
 
@@ -20,16 +22,15 @@ PlayState::PlayState()
     AssetManager::getInstance().loadTexture("assets/icons/Settings.png", "settings");
     AssetManager::getInstance().loadTexture("assets/icons/Pause.png", "pause");
     AssetManager::getInstance().loadFont("assets/fonts/mangabey-regular.otf", "mangabey");
-    AssetManager::getInstance().loadLevel("assets/map/tiled/level-1.tmx", "level-1");
+    AssetManager::getInstance().getTexture("settings").setSmooth(true);
+    AssetManager::getInstance().getTexture("pause").setSmooth(true);
+    AssetManager::getInstance().loadLevel("assets/map/tiled/level-1.tmx", "level-1", {"player", "settings", "pause"});
 
     m_defaultFont = AssetManager::getInstance().getFont("mangabey");
     m_playerTexture = AssetManager::getInstance().getTexture("player");
     m_settingsTexture = AssetManager::getInstance().getTexture("settings");
     m_pauseTexture = AssetManager::getInstance().getTexture("pause");
 
-    m_settingsTexture.setSmooth(true);
-    m_pauseTexture.setSmooth(true);
-
     const sf::Vector2f windowSize{GeometryDash::getInstance().getWindow().getWindow().getSize()};
     // Default button style
     const ButtonStyle buttonStyle{sf::Color::White,
@@ -66,14 +67,40 @@ PlayState::PlayState()
     m_processedCounter.setString("Rendered: 0");
 #endif // NDEBUG
 
-    m_arena = AssetManager::getInstance().getLevel("level-1");
+    // The level is shared with the AssetManager, a new run only resets the arena state
+    m_arena.setLevel(AssetManager::getInstance().getLevel("level-1"));
 
-    m_arena.resetPos();
     m_arena.setViewportSize(sf::Vector2f(GeometryDash::getInstance().getWindow().getWindow().getSize()));
     m_arena.setScrollSpeed(sf::Vector2f(250, 0));
 
-    m_player = Player(m_playerTexture, sf::Vector2f(150, 300), sf::Vector2f(32, 32),
+    // Take the player and icons from the level atlas so play never has to switch textures
+    const TextureAtlas &atlas = m_arena.getAtlas();
+    const sf::Texture *playerTexture = &m_playerTexture;
+    sf::Vector2i playerOrigin{0, 0};
+    if (atlas.contains("player"))
+    {
+        const AtlasRegion &region = atlas.getRegion("player");
+        playerTexture = atlas.getPage(region.page).get();
+        playerOrigin = region.rect.getPosition();
+    }
+    if (atlas.contains("pause"))
+    {
+        const AtlasRegion &region = atlas.getRegion("pause");
+        m_pauseButton.setTexture(*atlas.getPage(region.page));
+        m_pauseButton.setTextureRect(region.rect);
+    }
+    if (atlas.contains("settings"))
+    {
+        const AtlasRegion &region = atlas.getRegion("settings");
+        m_settingsButton.setTexture(*atlas.getPage(region.page));
+        m_settingsButton.setTextureRect(region.rect);
+    }
+
+    m_player = Player(*playerTexture, sf::Vector2f(150, 300), sf::Vector2f(32, 32),
                       PlayerAnimator(sf::Vector2f(64, 64), sf::Vector2i(), 0, 0, 10, sf::Vector2i(0, 0)));
+    m_player.getAnimator().setOrigin(playerOrigin);
+    m_replay = Replay(m_arena.getLevel().getFilePath(), GeometryDash::SimTickRate);
+    m_lastReplay = m_replay;
 
     GeometryDash::getInstance().getWindow().setClearColor(sf::Color::White);
 
@@ -110,7 +137,7 @@ void PlayState::update()
         }
         if (temp->restartGame())
         {
-            GeometryDash::getInstance().changeState(std::make_shared<PlayState>());
+            restart();
         }
         if (temp->toMenu())
         {
@@ -124,30 +151,16 @@ void PlayState::update()
 
     if (m_isPaused == false)
     {
-        // std::ranges::sort(m_gameObjects, [](const std::shared_ptr<GameObject> &a, const std::shared_ptr<GameObject>
-        // &b)
-        //                   { return a->getId() < b->getId(); });
-        m_arena.update();
-        m_player.update(m_arena);
-
 #ifndef NDEBUG
         m_collisionCounter.setString("Collisions: " + std::to_string(m_arena.getCollisionsThisFrame()));
         m_processedCounter.setString("Rendered: " + std::to_string(m_arena.getRenderedLastFrame()));
 #endif // NDEBUG
 
-        if (m_player.isDead() or
-            m_player.getPosition().y >
-                    static_cast<float>(GeometryDash::getInstance().getWindow().getWindow().getSize().y))
-        {
-            // Restart
-
-            // Temp
-            GeometryDash::getInstance().changeState(std::make_shared<PlayState>());
-        }
-
+        // The camera only follows what is drawn, so it moves with the real frame time
         const float lerpSpeed =
                 std::min(1.0f, m_cameraSmoothSpeed * GeometryDash::getInstance().getDeltaTime().asSeconds());
-        m_cameraPos.y = std::lerp(m_cameraPos.y, -m_player.getPosition().y + m_cameraOffset.y, lerpSpeed);
+        const sf::Vector2f player = m_player.getInterpolatedPosition(GeometryDash::getInstance().getInterpolation());
+        m_cameraPos.y = std::lerp(m_cameraPos.y, -player.y + m_cameraOffset.y, lerpSpeed);
     }
 
     // Color
@@ -165,9 +178,9 @@ void PlayState::update()
 
 
 #ifndef NDEBUG
-    m_avgFPS = static_cast<int>((std::floor(1000 / GeometryDash::getInstance().getDeltaTime().asMilliseconds())) +
-                                static_cast<float>(m_avgFPS)) /
-               2;
+    // Frames can take less than a millisecond, keep the fraction
+    const float frameTime = std::max(GeometryDash::getInstance().getDeltaTime().asSeconds(), 1e-6f);
+    m_avgFPS = static_cast<int>((std::floor(1 / frameTime) + static_cast<float>(m_avgFPS)) / 2);
     if (m_updateCount > 0.25)
     {
         m_updateCount = 0.0;
@@ -180,6 +193,49 @@ void PlayState::update()
 #endif // NDEBUG
 }
 
+void PlayState::tick()
+{
+    if (m_isPaused)
+        return;
+
+    const float dt = GeometryDash::getInstance().getTickTime().asSeconds();
+    m_arena.update(dt);
+    m_player.update(m_arena, dt);
+    ++m_tick;
+
+    if (m_player.isDead() or
+        m_player.getPosition().y > static_cast<float>(GeometryDash::getInstance().getWindow().getWindow().getSize().y))
+    {
+        restart();
+    }
+}
+
+void PlayState::restart()
+{
+    // Keep the run that just ended around so it can be saved, the swap reuses the events of the run before it
+    m_replay.finish(m_tick);
+    std::swap(m_replay, m_lastReplay);
+    m_replay.clear();
+    m_tick = 0;
+
+    m_arena.reset();
+    m_player.reset();
+
+    m_cameraPos = sf::Vector2f(0, 0);
+
+    m_topState = nullptr;
+    m_isPaused = false;
+}
+
+void PlayState::saveLastReplay() const
+{
+    if (m_lastReplay.getTicks() == 0)
+        return;
+
+    if (m_lastReplay.saveToFile(LAST_REPLAY_PATH))
+        SL_LOGF_INFO("Saved the last run to {}, {} ticks", LAST_REPLAY_PATH, m_lastReplay.getTicks());
+}
+
 void PlayState::openSettings()
 {
     if (m_topState)
@@ -224,12 +280,18 @@ void PlayState::handleEvent(const sf::Event &event)
             case sf::Keyboard::Escape:
                 openPause();
 
+                break;
+            case sf::Keyboard::F5:
+                saveLastReplay();
                 break;
             default:
                 break;
         }
     }
 
+    // Jumps land on the next tick, which is where a replay applies them
+    if (const std::optional<bool> jump = Player::getJumpInput(event); jump)
+        m_replay.record(m_tick, *jump);
     m_player.handleEvent(event);
 
     if (m_topState)
@@ -250,9 +312,9 @@ void PlayState::render()
     }
 #endif // NDEBUG
 
-    m_arena.render(m_cameraPos, fromHSL(m_hue, m_saturation, m_lightness));
-    // m_player.render(m_cameraPos);
-    m_player.render(m_cameraPos);
+    const float alpha = GeometryDash::getInstance().getInterpolation();
+    m_arena.render(m_cameraPos, fromHSL(m_hue, m_saturation, m_lightness), alpha);
+    m_player.render(m_cameraPos, alpha);
 
     m_pauseButton.render();
     m_settingsButton.render();
@@ -276,4 +338,9 @@ void PlayState::render()
 //     return *value;
 // }
 
-PlayState::~PlayState() { GeometryDash::getInstance().getWindow().setClearColor(sf::Color::White); }
+PlayState::~PlayState()
+{
+    // Leaving play is the one time the last run is saved without asking
+    saveLastReplay();
+    GeometryDash::getInstance().getWindow().setClearColor(sf::Color::White);
+}
@@ -0,0 +1,195 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "Profiler.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <utility>
+
+#include "simplelogger.hpp"
+
+namespace
+{
+// Zones open on this thread, for nesting them in the breakdown
+thread_local uint32_t OpenZones = 0;
+} // namespace
+
+std::atomic<bool> Profiler::Enabled = false;
+
+Profiler::Profiler() : m_epoch(std::chrono::steady_clock::now()) {}
+
+Profiler &Profiler::getInstance()
+{
+    static Profiler instance;
+    return instance;
+}
+
+void Profiler::SetEnabled(const bool enabled)
+{
+    SL_LOGF_DEBUG("Profiler {}", enabled ? "enabled" : "disabled");
+    Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+int64_t Profiler::now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+Profiler::ThreadBuffer &Profiler::getThreadBuffer()
+{
+    // Created the first time a thread records, the profiler keeps it alive after the thread is gone
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+
+        const std::scoped_lock lock(m_buffersMutex);
+        buffer->id = static_cast<uint32_t>(m_buffers.size());
+        m_buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Profiler::record(const ProfileEvent &event)
+{
+    ThreadBuffer &buffer = getThreadBuffer();
+    const std::scoped_lock lock(buffer.mutex);
+    buffer.events[buffer.written % BUFFER_SIZE] = event;
+    ++buffer.written;
+}
+
+void Profiler::endFrame()
+{
+    const int64_t time = now();
+    const int64_t lastFrame = std::exchange(m_lastFrame, time);
+    if (!IsEnabled())
+    {
+        m_frameStats.clear();
+        m_frameMilliseconds = 0;
+        return;
+    }
+
+    // Only this thread writes to its buffer, but a trace could be being saved
+    thread_local std::vector<ProfileEvent> frame;
+    frame.clear();
+    {
+        ThreadBuffer &buffer = getThreadBuffer();
+        const std::scoped_lock lock(buffer.mutex);
+        const uint64_t first = std::max(buffer.frameStart, buffer.written - std::min(buffer.written, BUFFER_SIZE));
+        for (uint64_t i = first; i < buffer.written; ++i)
+            frame.push_back(buffer.events[i % BUFFER_SIZE]);
+        buffer.frameStart = buffer.written;
+    }
+    // Zones are recorded when they end, children before their parents
+    std::ranges::sort(frame, {}, &ProfileEvent::start);
+
+    thread_local std::vector<ZoneStats> totals;
+    totals.clear();
+    for (const ProfileEvent &event: frame)
+    {
+        auto total = std::ranges::find(totals, event.name, &ZoneStats::name);
+        if (total == totals.end())
+            total = totals.insert(totals.end(), {event.name, event.depth, 0, 0});
+        total->milliseconds += static_cast<double>(event.duration) / 1e6;
+        total->calls += 1;
+    }
+
+    // Averages of zones that didn't run this frame fall towards 0
+    for (ZoneStats &stats: m_frameStats)
+    {
+        const auto total = std::ranges::find(totals, stats.name, &ZoneStats::name);
+        const double milliseconds = total != totals.end() ? total->milliseconds : 0;
+        const double calls = total != totals.end() ? total->calls : 0;
+        stats.milliseconds = stats.milliseconds * (1 - FRAME_SMOOTHING) + milliseconds * FRAME_SMOOTHING;
+        stats.calls = stats.calls * (1 - FRAME_SMOOTHING) + calls * FRAME_SMOOTHING;
+        if (total != totals.end())
+            stats.depth = total->depth;
+    }
+    // Zones that stopped running go once they'd show up less than every hundred frames
+    std::erase_if(m_frameStats, [](const ZoneStats &stats) { return stats.calls < 0.01; });
+    // New zones start out at what they took this frame rather than creeping up from 0
+    for (const ZoneStats &total: totals)
+    {
+        if (std::ranges::find(m_frameStats, total.name, &ZoneStats::name) == m_frameStats.end())
+            m_frameStats.push_back(total);
+    }
+
+    const double milliseconds = static_cast<double>(time - lastFrame) / 1e6;
+    m_frameMilliseconds = m_frameMilliseconds == 0
+                                  ? milliseconds
+                                  : m_frameMilliseconds * (1 - FRAME_SMOOTHING) + milliseconds * FRAME_SMOOTHING;
+}
+
+bool Profiler::saveChromeTrace(const std::string &filePath) const
+{
+    std::ofstream file(filePath);
+    if (!file)
+    {
+        SL_LOGF_ERROR("Failed to open {} for the profiler trace", filePath);
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        const std::scoped_lock lock(m_buffersMutex);
+        buffers = m_buffers;
+    }
+
+    size_t count = 0;
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for (const std::shared_ptr<ThreadBuffer> &buffer: buffers)
+    {
+        const std::scoped_lock lock(buffer->mutex);
+        file << std::format("{}{{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": {}, "
+                            "\"args\": {{\"name\": \"{}\"}}}}",
+                            buffer == buffers.front() ? "" : ",\n", buffer->id,
+                            buffer->id == 0 ? std::string("main") : std::format("thread {}", buffer->id));
+
+        // Timestamps are in microseconds
+        for (uint64_t i = buffer->written - std::min(buffer->written, BUFFER_SIZE); i < buffer->written; ++i)
+        {
+            const ProfileEvent &event = buffer->events[i % BUFFER_SIZE];
+            file << std::format(",\n{{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 0, \"tid\": {}, \"ts\": {:.3f}, "
+                                "\"dur\": {:.3f}}}",
+                                event.name, buffer->id, static_cast<double>(event.start) / 1e3,
+                                static_cast<double>(event.duration) / 1e3);
+            ++count;
+        }
+    }
+    file << "\n]}\n";
+
+    if (!file)
+    {
+        SL_LOGF_ERROR("Failed to write the profiler trace to {}", filePath);
+        return false;
+    }
+
+    SL_LOGF_INFO("Saved {} profiler events to {}", count, filePath);
+    return true;
+}
+
+void Profiler::clear()
+{
+    const std::scoped_lock lock(m_buffersMutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer: m_buffers)
+    {
+        const std::scoped_lock bufferLock(buffer->mutex);
+        buffer->written = 0;
+        buffer->frameStart = 0;
+    }
+    m_frameStats.clear();
+    m_frameMilliseconds = 0;
+}
+
+void ProfileZone::begin()
+{
+    m_depth = OpenZones++;
+    m_start = Profiler::getInstance().now();
+}
+
+void ProfileZone::end()
+{
+    --OpenZones;
+    Profiler &profiler = Profiler::getInstance();
+    profiler.record({m_name, m_start, profiler.now() - m_start, m_depth});
+}
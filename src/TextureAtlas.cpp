@@ -0,0 +1,181 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <format>
+
+#include "simplelogger.hpp"
+
+void TextureAtlas::add(const std::string &id, const sf::Image &image, const bool smooth)
+{
+    if (image.getSize().x == 0 or image.getSize().y == 0)
+    {
+        SL_LOGF_WARNING("Not adding empty image <{}> to the atlas", id);
+        return;
+    }
+
+    m_pending.push_back(PendingImage{id, image, smooth});
+}
+
+const AtlasRegion &TextureAtlas::getRegion(const std::string &id) const
+{
+    if (const auto found = m_regions.find(id); found != m_regions.end())
+        return found->second;
+
+    SL_LOGF_ERROR("Atlas does not contain <{}>", id);
+    return m_defaultRegion;
+}
+
+void TextureAtlas::clear()
+{
+    m_pending.clear();
+    m_regions.clear();
+    m_pages.clear();
+}
+
+bool TextureAtlas::build()
+{
+    if (m_pending.empty())
+        return true;
+
+    const unsigned maxSize = std::min(sf::Texture::getMaximumSize(), MAX_PAGE_SIZE);
+
+    // Tallest first keeps the shelves tight
+    std::ranges::stable_sort(m_pending, std::ranges::greater{},
+                             [](const PendingImage &pending) { return pending.image.getSize().y; });
+
+    struct Shelf
+    {
+        unsigned y = 0;
+        unsigned height = 0;
+        unsigned width = 0;
+    };
+
+    struct Page
+    {
+        std::vector<Shelf> shelves;
+        sf::Vector2u size{0, 0};
+        bool smooth = false;
+    };
+
+    struct Placement
+    {
+        size_t page = 0;
+        sf::Vector2u position{};
+    };
+
+    std::vector<Page> pages;
+    std::vector<Placement> placements;
+    placements.reserve(m_pending.size());
+
+    for (const auto &pending: m_pending)
+    {
+        const sf::Vector2u size = pending.image.getSize() + sf::Vector2u(PADDING * 2, PADDING * 2);
+        if (size.x > maxSize or size.y > maxSize)
+        {
+            SL_LOGF_ERROR("Image <{}> ({}x{}) is too large for an atlas page of {}", pending.id, size.x, size.y,
+                          maxSize);
+            return false;
+        }
+
+        // Fill the first shelf with room, otherwise open a new shelf or page
+        bool placed = false;
+        for (size_t p = 0; p < pages.size() and !placed; ++p)
+        {
+            if (pages[p].smooth != pending.smooth)
+                continue;
+
+            for (auto &shelf: pages[p].shelves)
+            {
+                if (shelf.height >= size.y and shelf.width + size.x <= maxSize)
+                {
+                    placements.push_back(Placement{p, sf::Vector2u(shelf.width, shelf.y)});
+                    shelf.width += size.x;
+                    pages[p].size.x = std::max(pages[p].size.x, shelf.width);
+                    placed = true;
+                    break;
+                }
+            }
+
+            if (!placed and pages[p].size.y + size.y <= maxSize)
+            {
+                pages[p].shelves.push_back(Shelf{pages[p].size.y, size.y, size.x});
+                placements.push_back(Placement{p, sf::Vector2u(0, pages[p].size.y)});
+                pages[p].size.x = std::max(pages[p].size.x, size.x);
+                pages[p].size.y += size.y;
+                placed = true;
+            }
+        }
+
+        if (!placed)
+        {
+            pages.push_back(Page{{Shelf{0, size.y, size.x}}, size, pending.smooth});
+            placements.push_back(Placement{pages.size() - 1, sf::Vector2u(0, 0)});
+        }
+    }
+
+    std::vector<sf::Image> pageImages(pages.size());
+    for (size_t p = 0; p < pages.size(); ++p)
+    {
+        pageImages[p].create(pages[p].size.x, pages[p].size.y, sf::Color::Transparent);
+    }
+
+    for (size_t i = 0; i < m_pending.size(); ++i)
+    {
+        const sf::Image &image = m_pending[i].image;
+        const sf::Vector2u size = image.getSize();
+        const sf::Vector2u position = placements[i].position + sf::Vector2u(PADDING, PADDING);
+        sf::Image &page = pageImages[placements[i].page];
+
+        page.copy(image, position.x, position.y);
+
+        // Extrude the edges into the padding so filtering never picks up a neighbour
+        const int w = static_cast<int>(size.x);
+        const int h = static_cast<int>(size.y);
+        for (unsigned k = 1; k <= PADDING; ++k)
+        {
+            page.copy(image, position.x, position.y - k, sf::IntRect(0, 0, w, 1));
+            page.copy(image, position.x, position.y + size.y - 1 + k, sf::IntRect(0, h - 1, w, 1));
+            page.copy(image, position.x - k, position.y, sf::IntRect(0, 0, 1, h));
+            page.copy(image, position.x + size.x - 1 + k, position.y, sf::IntRect(w - 1, 0, 1, h));
+
+            page.setPixel(position.x - k, position.y - k, image.getPixel(0, 0));
+            page.setPixel(position.x + size.x - 1 + k, position.y - k, image.getPixel(size.x - 1, 0));
+            page.setPixel(position.x - k, position.y + size.y - 1 + k, image.getPixel(0, size.y - 1));
+            page.setPixel(position.x + size.x - 1 + k, position.y + size.y - 1 + k,
+                          image.getPixel(size.x - 1, size.y - 1));
+        }
+
+        m_regions[m_pending[i].id] = AtlasRegion{placements[i].page,
+                                                 sf::IntRect(static_cast<int>(position.x),
+                                                             static_cast<int>(position.y), w, h)};
+    }
+
+    const size_t firstPage = m_pages.size();
+    for (size_t p = 0; p < pages.size(); ++p)
+    {
+        auto texture = std::make_shared<sf::Texture>();
+        if (!texture->loadFromImage(pageImages[p]))
+        {
+            SL_LOGF_ERROR("Failed to upload atlas page {}", m_pages.size());
+            return false;
+        }
+        texture->setSmooth(pages[p].smooth);
+
+        m_pages.push_back(texture);
+    }
+
+    // Pages from an earlier build come first
+    if (firstPage != 0)
+    {
+        for (const auto &pending: m_pending)
+        {
+            m_regions[pending.id].page += firstPage;
+        }
+    }
+
+    SL_LOGF_DEBUG("Packed {} images into {} atlas pages", m_pending.size(), pageImages.size());
+    m_pending.clear();
+
+    return true;
+}
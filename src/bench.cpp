@@ -0,0 +1,1074 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AssetManager.h"
+#include "game/Arena.h"
+#include "game/ColliderBatch.h"
+#include "game/Collision.h"
+#include "game/LayerParser.h"
+#include "game/Level.h"
+#include "game/LevelFile.h"
+#include "game/Player.h"
+#include "game/PlayerBatch.h"
+#include "game/TileCollider.h"
+#include "simplelogger.hpp"
+#include "zlib.h"
+#include "zstd.h"
+
+/* Micro and macro benchmarks of the engine's hot paths. Everything runs on generated data that is the same on every
+ * run, levels are generated at a few sizes. Each result is the fastest of a few repetitions, along with the
+ * allocations it made
+ * Usage: GeometryDash2Bench [--json] [--filter text] [--repeat count]
+ *   --json prints the results as json instead of a table, notes go to stderr */
+
+namespace
+{
+// Every allocation of the process goes through the operator new below, so a benchmark can tell how many it made
+std::atomic<size_t> AllocationCount = 0;
+std::atomic<size_t> AllocatedBytes = 0;
+
+void *allocate(const size_t size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size); memory != nullptr)
+        return memory;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void *operator new(const size_t size) { return allocate(size); }
+void *operator new[](const size_t size) { return allocate(size); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, size_t) noexcept { std::free(memory); }
+
+namespace
+{
+using BenchClock = std::chrono::steady_clock;
+
+struct Settings
+{
+    bool json = false;
+    std::string filter;
+    int repeat = 5;
+};
+Settings BenchSettings;
+
+struct Result
+{
+    std::string name;
+    std::string variant;
+    // What size counts depends on the benchmark: cells of a layer or level, boxes, colliders or players
+    size_t size = 0;
+    double nsPerOp = 0;
+    double opsPerSecond = 0;
+    // Only for benchmarks that go through data, 0 for the others
+    double megabytesPerSecond = 0;
+    double allocationsPerOp = 0;
+    double allocatedBytesPerOp = 0;
+};
+std::vector<Result> Results;
+// Everything the benchmarks compute ends up here so none of it can be optimized away
+volatile size_t Sink = 0;
+
+bool isEnabled(const std::string &name)
+{
+    return BenchSettings.filter.empty() or name.find(BenchSettings.filter) != std::string::npos;
+}
+
+// The table and the notes share stdout, with json only the json is written there
+std::ostream &notes() { return BenchSettings.json ? std::cerr : std::cout; }
+
+// Checks that didn't hold, any of them makes the bench exit with 1
+size_t Failures = 0;
+
+/* Reports a check that didn't hold, on stderr so json output can't hide it */
+void fail(const std::string &message)
+{
+    std::cerr << "FAILED: " << message << "\n";
+    ++Failures;
+}
+
+/* Times iterations calls of func, the fastest of the repetitions counts. func returns something that depends on its
+ * work, bytes is how much data one call goes through */
+template<typename Func>
+void measure(const std::string &name, const std::string &variant, const size_t size, const size_t iterations,
+             const double bytes, Func &&func)
+{
+    // Warms up caches and lets lazily grown buffers reach their size
+    size_t sink = func();
+
+    double best = std::numeric_limits<double>::infinity();
+    size_t allocations = 0;
+    size_t allocated = 0;
+    for (int r = 0; r < BenchSettings.repeat; ++r)
+    {
+        const size_t countBefore = AllocationCount.load(std::memory_order_relaxed);
+        const size_t bytesBefore = AllocatedBytes.load(std::memory_order_relaxed);
+        const auto start = BenchClock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            sink += func();
+        }
+        const std::chrono::duration<double> elapsed = BenchClock::now() - start;
+
+        if (elapsed.count() < best)
+        {
+            best = elapsed.count();
+            allocations = AllocationCount.load(std::memory_order_relaxed) - countBefore;
+            allocated = AllocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+        }
+    }
+    Sink = Sink + sink;
+
+    const double ops = static_cast<double>(iterations);
+    Result result{name, variant, size};
+    result.nsPerOp = best * 1e9 / ops;
+    result.opsPerSecond = ops / std::max(best, 1e-12);
+    result.megabytesPerSecond = bytes * result.opsPerSecond / (1024.0 * 1024.0);
+    result.allocationsPerOp = static_cast<double>(allocations) / ops;
+    result.allocatedBytesPerOp = static_cast<double>(allocated) / ops;
+
+    if (!BenchSettings.json)
+    {
+        std::cout << std::format("  {:<24} {:>9} {:>14.1f} ns/op {:>14.0f} op/s", variant, size, result.nsPerOp,
+                                 result.opsPerSecond);
+        if (bytes > 0)
+            std::cout << std::format(" {:>9.1f} MB/s", result.megabytesPerSecond);
+        std::cout << std::format(" {:>9.2f} allocs/op\n", result.allocationsPerOp);
+    }
+    Results.push_back(std::move(result));
+}
+
+/* Starts a group of results in the table */
+bool beginBenchmark(const std::string &name, const std::string &description)
+{
+    if (!isEnabled(name))
+        return false;
+
+    if (!BenchSettings.json)
+        std::cout << name << ", " << description << "\n";
+    return true;
+}
+
+std::string escapeJson(const std::string &text)
+{
+    std::string escaped;
+    for (const char c: text)
+    {
+        switch (c)
+        {
+            case '"':
+            case '\\':
+                escaped += '\\';
+                escaped += c;
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                // Other control characters can only be written as their code
+                if (static_cast<unsigned char>(c) < 0x20)
+                    escaped += std::format("\\u{:04x}", static_cast<unsigned char>(c));
+                else
+                    escaped += c;
+                break;
+        }
+    }
+    return escaped;
+}
+
+void printJson()
+{
+    std::cout << "{\n  \"sweep_batch_path\": \"" << getSweepBatchPath() << "\",\n  \"repeat\": "
+              << BenchSettings.repeat << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < Results.size(); ++i)
+    {
+        const Result &result = Results[i];
+        std::cout << std::format("    {{\"name\": \"{}\", \"variant\": \"{}\", \"size\": {}, \"ns_per_op\": {:.3f}, "
+                                 "\"ops_per_s\": {:.3f}, \"mb_per_s\": {:.3f}, \"allocs_per_op\": {:.4f}, "
+                                 "\"alloc_bytes_per_op\": {:.1f}}}{}\n",
+                                 escapeJson(result.name), escapeJson(result.variant), result.size, result.nsPerOp,
+                                 result.opsPerSecond, result.megabytesPerSecond, result.allocationsPerOp,
+                                 result.allocatedBytesPerOp, i + 1 < Results.size() ? "," : "");
+    }
+    std::cout << "  ]\n}\n";
+}
+
+// Enough calls that every repetition takes a while, whatever the size
+size_t getIterations(const size_t work, const size_t size)
+{
+    return std::max<size_t>(1, work / std::max<size_t>(size, 1));
+}
+
+// Generates a layer the way tiled writes it, mostly empty with flipped tiles mixed in
+std::string generateLayer(const size_t width, const size_t height)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<uint32_t> tile(0, 99);
+    std::uniform_int_distribution<uint32_t> flags(0, 7);
+
+    std::string layer;
+    layer.reserve(width * height * 4);
+    layer += '\n';
+    for (size_t r = 0; r < height; ++r)
+    {
+        for (size_t c = 0; c < width; ++c)
+        {
+            uint32_t gid = tile(random);
+            gid = gid < 70 ? 0 : gid - 69;
+            if (gid != 0)
+                gid |= flags(random) << 29;
+
+            layer += std::to_string(gid);
+            if (r != height - 1 or c != width - 1)
+                layer += ',';
+        }
+        layer += '\n';
+    }
+
+    return layer;
+}
+
+std::string encodeBase64(const std::string &data)
+{
+    constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string encoded;
+    encoded.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3)
+    {
+        uint32_t bits = static_cast<uint8_t>(data[i]) << 16;
+        if (i + 1 < data.size())
+            bits |= static_cast<uint8_t>(data[i + 1]) << 8;
+        if (i + 2 < data.size())
+            bits |= static_cast<uint8_t>(data[i + 2]);
+
+        encoded += alphabet[bits >> 18 & 63];
+        encoded += alphabet[bits >> 12 & 63];
+        encoded += i + 1 < data.size() ? alphabet[bits >> 6 & 63] : '=';
+        encoded += i + 2 < data.size() ? alphabet[bits & 63] : '=';
+    }
+
+    return encoded;
+}
+
+// The same layer as tiled's base64 encodings
+std::string generateBase64Layer(const std::vector<uint32_t> &map, const LayerCompression compression)
+{
+    const std::string raw(reinterpret_cast<const char *>(map.data()), map.size() * sizeof(uint32_t));
+    switch (compression)
+    {
+        case LayerCompression::None:
+            return encodeBase64(raw);
+        case LayerCompression::Zlib:
+        case LayerCompression::Gzip:
+        {
+            uLongf size = compressBound(static_cast<uLong>(raw.size()));
+            std::string compressed(size, '\0');
+            compress2(reinterpret_cast<Bytef *>(compressed.data()), &size,
+                      reinterpret_cast<const Bytef *>(raw.data()), static_cast<uLong>(raw.size()), Z_BEST_COMPRESSION);
+            compressed.resize(size);
+            return encodeBase64(compressed);
+        }
+        case LayerCompression::Zstd:
+        {
+            std::string compressed(ZSTD_compressBound(raw.size()), '\0');
+            compressed.resize(ZSTD_compress(compressed.data(), compressed.size(), raw.data(), raw.size(), 19));
+            return encodeBase64(compressed);
+        }
+    }
+
+    return {};
+}
+
+// The original parser, kept for comparison
+size_t parseLegacy(const std::string &layer, std::vector<uint32_t> &out)
+{
+    size_t pos = 0;
+    std::string cSquare;
+    for (const char i: layer)
+    {
+        if (i == ',')
+        {
+            out[pos++] = static_cast<uint32_t>(std::stoll(cSquare));
+            cSquare.clear();
+            continue;
+        }
+        if (i == '\n')
+            continue;
+
+        cSquare += i;
+    }
+
+    return pos;
+}
+
+
+// The original angle based triangle test, kept for comparison
+class LegacyTriangleCollider
+{
+public:
+    LegacyTriangleCollider(const sf::Vector2f &leftPoint, const sf::Vector2f &rightPoint,
+                           const sf::Vector2f &topPoint) :
+        m_leftPoint(leftPoint), m_rightPoint(rightPoint), m_topPoint(topPoint)
+    {
+        const sf::Vector2f leftToRight = rightPoint - leftPoint;
+        const sf::Vector2f leftToTop = topPoint - leftPoint;
+        m_leftMinAngle = std::atan2(leftToTop.y, leftToTop.x);
+        m_leftMaxAngle = std::atan2(leftToRight.y, leftToRight.x);
+
+        const sf::Vector2f rightToTop = topPoint - rightPoint;
+        const sf::Vector2f rightToLeft = -leftToRight;
+        m_rightMaxAngle = std::atan2(rightToTop.y, rightToTop.x);
+        m_rightMinAngle = std::atan2(rightToLeft.y, rightToLeft.x);
+    }
+
+    [[nodiscard]] bool collides(const sf::FloatRect &shape) const
+    {
+        if (std::ranges::any_of(std::array<sf::Vector2f, 4>({
+                                        sf::Vector2f(shape.left, shape.top),
+                                        sf::Vector2f(shape.left + shape.width, shape.top),
+                                        sf::Vector2f(shape.left, shape.top + shape.height),
+                                        sf::Vector2f(shape.left + shape.width, shape.top + shape.height),
+                                }),
+                                [this](const sf::Vector2f &point) { return inside(point); }))
+            return true;
+
+        return std::ranges::any_of(std::array<sf::Vector2f, 3>({m_leftPoint, m_rightPoint, m_topPoint}),
+                                   [shape](const sf::Vector2f &point) { return shape.contains(point); });
+    }
+
+private:
+    [[nodiscard]] bool inside(const sf::Vector2f &point) const
+    {
+        sf::Vector2f angle = point - m_leftPoint;
+        if (float angleSlope = std::atan2(angle.y, angle.x);
+            angleSlope > m_leftMinAngle and angleSlope < m_leftMaxAngle)
+        {
+            angle = point - m_rightPoint;
+            if (angleSlope = std::atan2(angle.y, angle.x);
+                angleSlope > m_rightMinAngle and angleSlope < m_rightMaxAngle)
+                return true;
+        }
+
+        return false;
+    }
+
+    float m_leftMinAngle = 0;
+    float m_leftMaxAngle = 0;
+    float m_rightMinAngle = 0;
+    float m_rightMaxAngle = 0;
+
+    sf::Vector2f m_leftPoint;
+    sf::Vector2f m_rightPoint;
+    sf::Vector2f m_topPoint;
+};
+
+
+// Layers and levels are generated at these sizes, in cells
+const std::array<sf::Vector2i, 3> LAYER_SIZES{sf::Vector2i(500, 50), sf::Vector2i(2000, 200), sf::Vector2i(8000, 500)};
+const std::array<int, 3> LEVEL_WIDTHS{500, 2000, 8000};
+constexpr int LEVEL_HEIGHT = 50;
+
+// The same setup PlayState plays with in the default window
+const sf::Vector2f PLAYER_SPAWN{150, 300};
+const sf::Vector2f PLAYER_SIZE{32, 32};
+const sf::Vector2f SCROLL_SPEED{250, 0};
+const sf::Vector2f VIEWPORT_SIZE{1200, 800};
+constexpr float TICK = 1.0f / 240;
+
+void benchLayerParser()
+{
+    if (!beginBenchmark("parseLayer", "layers from the level loader, MB/s of the csv so the encodings compare"))
+        return;
+
+    for (const sf::Vector2i &size: LAYER_SIZES)
+    {
+        const size_t cells = static_cast<size_t>(size.x) * size.y;
+        const std::string layer = generateLayer(size.x, size.y);
+        const double bytes = static_cast<double>(layer.size());
+        const size_t iterations = getIterations(4'000'000, cells);
+        std::vector<uint32_t> map(cells);
+
+        // Parsed once up front so a broken parser is reported once rather than on every call
+        size_t count = 0;
+        if (!parseCsvLayer(layer, map, count))
+        {
+            notes() << "    Failed to parse the generated csv layer\n";
+            continue;
+        }
+        measure("parseLayer", "csv", cells, iterations, bytes,
+                [&] { return parseCsvLayer(layer, map, count) ? count : 0; });
+        measure("parseLayer", "csv legacy", cells, iterations, bytes, [&] { return parseLegacy(layer, map); });
+
+        for (const auto &[name, compression]: {std::pair{"base64", LayerCompression::None},
+                                               std::pair{"base64 zlib", LayerCompression::Zlib},
+                                               std::pair{"base64 zstd", LayerCompression::Zstd}})
+        {
+            const std::string encoded = generateBase64Layer(map, compression);
+            std::vector<uint32_t> decoded(map.size());
+            if (!parseBase64Layer(encoded, compression, decoded, count) or decoded != map)
+            {
+                notes() << "    Failed to parse the generated " << name << " layer\n";
+                continue;
+            }
+            measure("parseLayer", name, cells, iterations, bytes,
+                    [&] { return parseBase64Layer(encoded, compression, decoded, count) ? count : 0; });
+        }
+    }
+}
+
+// Gids of the tile sets every generated level uses, the same ones level-1 uses
+constexpr uint32_t GROUND_GID = 8;
+constexpr uint32_t TINY_SPIKE_GID = 49;
+constexpr uint32_t SPIKE_GID = 53;
+constexpr uint32_t FLIPPED_HORIZONTALLY = 0x80000000;
+
+/* Something like a real level rather than noise: a floor with steps, floating platforms and spikes on it */
+std::vector<uint32_t> generateLevelMap(const int width, const int height)
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> obstacle(0, 5);
+    std::uniform_int_distribution<int> gap(4, 12);
+
+    std::vector<uint32_t> map(static_cast<size_t>(width) * height, 0);
+    const auto set = [&](const int column, const int row, const uint32_t gid)
+    {
+        if (column >= 0 and column < width and row >= 0 and row < height)
+            map[static_cast<size_t>(row) * width + column] = gid;
+    };
+
+    const int floor = height - 4;
+    for (int column = 0; column < width; ++column)
+    {
+        for (int row = floor; row < height; ++row)
+            set(column, row, GROUND_GID);
+    }
+
+    for (int column = 16; column < width; column += gap(random))
+    {
+        switch (obstacle(random))
+        {
+            case 0:
+                set(column, floor - 1, SPIKE_GID);
+                break;
+            case 1:
+                set(column, floor - 1, TINY_SPIKE_GID | FLIPPED_HORIZONTALLY);
+                set(column + 1, floor - 1, TINY_SPIKE_GID);
+                break;
+            case 2:
+                set(column, floor - 1, GROUND_GID);
+                set(column + 1, floor - 1, GROUND_GID);
+                break;
+            case 3:
+                for (int c = column; c < column + 4; ++c)
+                    set(c, floor - 3, GROUND_GID);
+                break;
+            default:
+                set(column, floor - 1, GROUND_GID);
+                set(column + 1, floor - 1, SPIKE_GID);
+                break;
+        }
+    }
+
+    return map;
+}
+
+/* Writes a generated level as a tiled map with the tile sets of level-1, returns its path */
+std::string writeLevel(const int width, const int height)
+{
+    const std::filesystem::path folder = std::filesystem::temp_directory_path() / "geometrydash2-bench";
+    std::filesystem::create_directories(folder);
+    const std::string path = (folder / std::format("level-{}x{}.tmx", width, height)).string();
+
+    const std::vector<uint32_t> map = generateLevelMap(width, height);
+    std::ofstream file(path, std::ios::trunc);
+    file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+         << std::format("<map version=\"1.10\" orientation=\"orthogonal\" renderorder=\"right-down\" width=\"{}\" "
+                        "height=\"{}\" tilewidth=\"64\" tileheight=\"64\" infinite=\"0\">\n",
+                        width, height)
+         << R"( <tileset firstgid="1" name="SimpleTileSet" tilewidth="64" tileheight="64" tilecount="48" columns="8">
+  <image source="../WhiteSquares.png" width="512" height="384"/>
+ </tileset>
+ <tileset firstgid="49" name="TinySpikes" tilewidth="64" tileheight="64" tilecount="4" columns="2">
+  <image source="../SmallSpikes.png" width="128" height="128"/>
+ </tileset>
+ <tileset firstgid="53" name="Spikes" tilewidth="64" tileheight="64" tilecount="4" columns="2">
+  <image source="../Spikes.png" width="128" height="128"/>
+ </tileset>
+)" << std::format(" <layer id=\"1\" name=\"Tile Layer 1\" width=\"{}\" height=\"{}\">\n  <data encoding=\"csv\">\n",
+                  width, height);
+    for (size_t i = 0; i < map.size(); ++i)
+    {
+        file << map[i];
+        if (i + 1 != map.size())
+            file << ',';
+        if ((i + 1) % width == 0)
+            file << '\n';
+    }
+    file << "</data>\n </layer>\n</map>\n";
+
+    // A compiled level left over from another run would be loaded instead
+    std::filesystem::remove(LevelData::getCompiledPath(path));
+    return path;
+}
+
+// The generated levels, loaded once for everything that only needs them loaded
+struct BenchLevel
+{
+    std::string path;
+    size_t cells = 0;
+    std::shared_ptr<const Level> level;
+};
+
+const std::vector<BenchLevel> &getLevels()
+{
+    static const std::vector<BenchLevel> levels = []
+    {
+        std::vector<BenchLevel> loaded;
+        for (const int width: LEVEL_WIDTHS)
+        {
+            BenchLevel level{writeLevel(width, LEVEL_HEIGHT), static_cast<size_t>(width) * LEVEL_HEIGHT, nullptr};
+            const auto data = std::make_shared<Level>();
+            if (!data->loadFromFile(level.path, {}, false))
+                notes() << "Failed to load " << level.path << "\n";
+            level.level = data;
+            loaded.push_back(std::move(level));
+        }
+        return loaded;
+    }();
+    return levels;
+}
+
+void benchLevelLoading()
+{
+    if (!beginBenchmark("loadFromFile", "generated levels without graphics, MB/s of the tmx"))
+        return;
+
+    for (const BenchLevel &level: getLevels())
+    {
+        const double bytes = static_cast<double>(std::filesystem::file_size(level.path));
+        const size_t iterations = getIterations(2'000'000, level.cells);
+
+        measure("loadFromFile", "LevelData::loadFromTmx", level.cells, iterations, bytes, [&]
+        {
+            LevelData data;
+            if (!data.loadFromTmx(level.path))
+                notes() << "Failed to parse " << level.path << "\n";
+            return data.getMap().size();
+        });
+        measure("loadFromFile", "Level::loadFromFile tmx", level.cells, iterations, bytes, [&]
+        {
+            Level loaded;
+            if (!loaded.loadFromFile(level.path, {}, false))
+                notes() << "Failed to load " << level.path << "\n";
+            return loaded.getTileCount();
+        });
+
+        // Mapping a compiled level in costs next to nothing, what is left of loading it is createWorld
+        LevelData data;
+        const std::string compiledPath = LevelData::getCompiledPath(level.path);
+        if (!data.loadFromTmx(level.path) or !data.saveCompiled(compiledPath, level.path))
+        {
+            notes() << "Failed to compile " << level.path << "\n";
+            continue;
+        }
+        measure("createWorld", "compiled level", level.cells, iterations, 0, [&]
+        {
+            Level loaded;
+            if (!loaded.loadFromFile(level.path, {}, false))
+                notes() << "Failed to load " << compiledPath << "\n";
+            return loaded.getTileCount();
+        });
+        std::filesystem::remove(compiledPath);
+    }
+}
+
+void benchArenaCollision()
+{
+    if (!beginBenchmark("collidePlayer", "player sized boxes anywhere in the generated levels"))
+        return;
+
+    for (const BenchLevel &level: getLevels())
+    {
+        Arena arena;
+        arena.setLevel(level.level);
+        arena.setViewportSize(VIEWPORT_SIZE);
+
+        // Boxes are relative to the arena, most of them near the floor where the tiles are
+        std::mt19937 random(42);
+        const sf::Vector2f levelSize(static_cast<float>(level.level->getSize().x * level.level->getTileSize().x),
+                                     static_cast<float>(level.level->getSize().y * level.level->getTileSize().y));
+        std::uniform_real_distribution<float> x(0, levelSize.x - PLAYER_SIZE.x);
+        std::uniform_real_distribution<float> y(levelSize.y - 64 * 8, levelSize.y - PLAYER_SIZE.y);
+        std::uniform_real_distribution<float> fall(-8, 8);
+        std::vector<sf::FloatRect> shapes(4096);
+        std::vector<sf::Vector2f> deltas(shapes.size());
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            shapes[i] = sf::FloatRect(sf::Vector2f(x(random), y(random)) - arena.getPosition(), PLAYER_SIZE);
+            deltas[i] = sf::Vector2f(SCROLL_SPEED.x * TICK, fall(random));
+        }
+
+        // Every tile whose collider overlaps a box has to be found, in the order collidePlayer picks the first one
+        std::vector<TileHit> hits;
+        std::vector<size_t> expected;
+        for (const sf::FloatRect &shape: shapes)
+        {
+            const sf::FloatRect world(shape.getPosition() + arena.getPosition(), shape.getSize());
+            const float tileWidth = static_cast<float>(level.level->getTileSize().x);
+            expected.clear();
+            for (size_t tile = level.level->findFirstTile(world.left - tileWidth);
+                 tile < level.level->findLastTile(world.left + world.width); ++tile)
+            {
+                if (collides(level.level->getCollider(tile), world))
+                    expected.push_back(tile);
+            }
+            std::ranges::sort(expected, [&](const size_t a, const size_t b)
+                              { return level.level->isVisitedBefore(a, b); });
+
+            hits.clear();
+            arena.collidePlayerAll(shape, hits);
+            const std::optional<TileHit> hit = arena.collidePlayer(shape);
+            if (!std::ranges::equal(hits, expected, {}, &TileHit::tile) or
+                hit.has_value() != !hits.empty() or (hit and hit->tile != hits.front().tile))
+            {
+                fail(std::format("Arena::collidePlayerAll found {} tiles instead of {} at {}, {}", hits.size(),
+                                 expected.size(), world.left, world.top));
+                break;
+            }
+        }
+
+        const size_t iterations = shapes.size() * 64;
+        size_t next = 0;
+        measure("collidePlayer", "Arena::collidePlayer", level.cells, iterations, 0,
+                [&] { return arena.collidePlayer(shapes[next++ % shapes.size()]).has_value() ? 1 : 0; });
+        measure("collidePlayer", "Arena::collidePlayerAll", level.cells, iterations, 0, [&]
+        {
+            hits.clear();
+            return arena.collidePlayerAll(shapes[next++ % shapes.size()], hits);
+        });
+        measure("collidePlayer", "Arena::sweepPlayer", level.cells, iterations, 0, [&]
+        {
+            const size_t i = next++ % shapes.size();
+            return arena.sweepPlayer(shapes[i], deltas[i]).has_value() ? 1 : 0;
+        });
+    }
+}
+
+void benchTriangleCollider()
+{
+    if (!beginBenchmark("TriangleCollider::collides", "boxes around a spike"))
+        return;
+
+    constexpr size_t count = 100000;
+
+    // A spike the size of a tile and boxes of any shape scattered around it, thin ones can cross it without
+    // containing a corner
+    const sf::Vector2f left(0, 64);
+    const sf::Vector2f right(64, 64);
+    const sf::Vector2f top(32, 0);
+    const TriangleCollider triangle{left, right, top};
+    const LegacyTriangleCollider legacy{left, right, top};
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-48, 96);
+    std::uniform_real_distribution<float> size(2, 96);
+    std::vector<sf::FloatRect> shapes(count);
+    for (auto &shape: shapes)
+    {
+        shape = sf::FloatRect(position(random), position(random), size(random), size(random));
+    }
+
+    size_t next = 0;
+    measure("TriangleCollider::collides", "edge functions", count, count * 20, 0,
+            [&] { return triangle.collides(shapes[next++ % count]) ? 1 : 0; });
+    measure("TriangleCollider::collides", "legacy", count, count * 20, 0,
+            [&] { return legacy.collides(shapes[next++ % count]) ? 1 : 0; });
+
+    const auto missed = std::ranges::count_if(
+            shapes, [&](const sf::FloatRect &shape) { return triangle.collides(shape) != legacy.collides(shape); });
+    notes() << "    legacy disagrees on " << missed << " boxes\n";
+}
+
+void benchColliderBatch()
+{
+    if (!beginBenchmark("sweepBatch", std::format("one falling box against every collider of a batch, {} kernels",
+                                                  getSweepBatchPath())))
+        return;
+
+    constexpr size_t queries = 1 << 20;
+    for (const size_t count: {1, 4, 16, 64, 256, 1024})
+    {
+        // A row of blocks and spikes with the player sized box sweeping over them
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> type(0, 2);
+        std::uniform_int_distribution<int> frame(0, 3);
+        std::vector<Collider> colliders;
+        ColliderBatch batch;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const sf::Vector2f position(static_cast<float>(i % 32) * 64, static_cast<float>(i / 32) * 64);
+            colliders.push_back(makeTileCollider(static_cast<ArenaItemType>(type(random)), frame(random), position,
+                                                 sf::Vector2f(64, 64)));
+            batch.add(colliders.back());
+        }
+
+        std::uniform_real_distribution<float> x(-32, static_cast<float>(std::min<size_t>(count, 32)) * 64);
+        std::uniform_real_distribution<float> y(-32, static_cast<float>((count + 31) / 32) * 64);
+        std::uniform_real_distribution<float> fall(-32, 32);
+        std::vector<sf::FloatRect> shapes(256);
+        std::vector<sf::Vector2f> deltas(shapes.size());
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            shapes[i] = sf::FloatRect(x(random), y(random), 32, 32);
+            deltas[i] = sf::Vector2f(SCROLL_SPEED.x * TICK, fall(random));
+        }
+
+        // The same number of collider tests for every count
+        const size_t iterations = getIterations(queries, count);
+        std::vector<float> times(count);
+        std::vector<uint8_t> axes(count);
+        std::vector<float> scalarTimes(count);
+        std::vector<uint8_t> scalarAxes(count);
+        const auto countHits = [](const std::vector<float> &sweeps)
+        { return static_cast<size_t>(std::ranges::count_if(sweeps, [](const float time) { return time < 1; })); };
+
+        size_t next = 0;
+        measure("sweepBatch", "one at a time", count, iterations, 0, [&]
+        {
+            const size_t i = next++ % shapes.size();
+            size_t hits = 0;
+            for (const auto &collider: colliders)
+            {
+                hits += sweep(collider, shapes[i], deltas[i]).has_value();
+            }
+            return hits;
+        });
+        measure("sweepBatch", "scalar batch", count, iterations, 0, [&]
+        {
+            const size_t i = next++ % shapes.size();
+            sweepBatchScalar(batch, shapes[i], deltas[i], scalarTimes, scalarAxes);
+            return countHits(scalarTimes);
+        });
+        measure("sweepBatch", std::format("{} batch", getSweepBatchPath()), count, iterations, 0, [&]
+        {
+            const size_t i = next++ % shapes.size();
+            sweepBatch(batch, shapes[i], deltas[i], times, axes);
+            return countHits(times);
+        });
+
+        // Replays depend on every path giving the colliders' own answers to the bit
+        size_t mismatches = 0;
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            sweepBatchScalar(batch, shapes[i], deltas[i], scalarTimes, scalarAxes);
+            sweepBatch(batch, shapes[i], deltas[i], times, axes);
+            for (size_t c = 0; c < count; ++c)
+            {
+                const std::optional<SweepHit> hit = sweep(colliders[c], shapes[i], deltas[i]);
+                const auto matches = [&](const float time, const uint8_t axis)
+                {
+                    if (!hit)
+                        return time == INFINITY;
+                    return time == hit->time and batch.getSweepNormal(c, axis) == hit->normal;
+                };
+                mismatches += !matches(times[c], axes[c]) or !matches(scalarTimes[c], scalarAxes[c]);
+            }
+        }
+        if (mismatches != 0)
+            fail(std::format("{} sweeps of {} colliders differ between the batch paths and the colliders", mismatches,
+                             count));
+    }
+}
+
+void benchFromHSL()
+{
+    if (!beginBenchmark("fromHSL", "the background and tint colour of every frame"))
+        return;
+
+    uint32_t step = 0;
+    measure("fromHSL", "hue wheel", 1, 1 << 22, 0, [&]
+    {
+        // Walks the hue around the wheel like PlayState does
+        const sf::Color color = fromHSL(static_cast<float>(step++ % 3600) / 3600.0f, 0.5f, 0.5f);
+        return static_cast<size_t>(color.r + color.g + color.b);
+    });
+}
+
+void benchSimulation()
+{
+    if (!beginBenchmark("PlayState::tick", "the simulation of one tick without a window, restarting on death"))
+        return;
+
+    for (const BenchLevel &level: getLevels())
+    {
+        Arena arena;
+        arena.setLevel(level.level);
+        arena.setViewportSize(VIEWPORT_SIZE);
+        arena.setScrollSpeed(SCROLL_SPEED);
+        Player player(PLAYER_SPAWN, PLAYER_SIZE,
+                      PlayerAnimator(sf::Vector2f(64, 64), sf::Vector2i(), 0, 0, 10, sf::Vector2i(0, 0)));
+
+        // The same work as PlayState::tick with a jump held every so often
+        uint32_t tick = 0;
+        measure("PlayState::tick", "headless", level.cells, 1 << 18, 0, [&]
+        {
+            if (tick % 41 == 0)
+                player.pressJump();
+            else if (tick % 41 == 5)
+                player.releaseJump();
+            ++tick;
+
+            arena.update(TICK);
+            player.update(arena, TICK);
+            if (player.isDead() or player.getPosition().y > VIEWPORT_SIZE.y)
+            {
+                arena.reset();
+                player.reset();
+                tick = 0;
+            }
+            return static_cast<size_t>(player.getPosition().y);
+        });
+    }
+}
+
+/* Every player of the batch benchmarks presses jump on its own beat and lets go a few ticks later */
+std::optional<bool> getBeatJump(const size_t player, const uint32_t tick)
+{
+    const uint32_t beat = 20 + static_cast<uint32_t>(player % 61);
+    if (tick % beat == 0)
+        return true;
+    if (tick % beat == 3)
+        return false;
+    return std::nullopt;
+}
+
+void playBeatJumps(PlayerBatch &batch, const size_t first, const size_t last, const uint32_t tick)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        if (const std::optional<bool> jump = getBeatJump(i, tick); jump)
+            *jump ? batch.pressJump(i) : batch.releaseJump(i);
+    }
+}
+
+Arena makeBatchArena(const BenchLevel &level)
+{
+    Arena arena;
+    arena.setLevel(level.level);
+    arena.setViewportSize(VIEWPORT_SIZE);
+    arena.setScrollSpeed(SCROLL_SPEED);
+    return arena;
+}
+
+/* Plays the same jumps through separate Players and a PlayerBatch, which has to move every player exactly like Player
+ * does. Fails on the first player and tick they disagree, then checks that threads don't change where simulate ends */
+void checkPlayerBatch(const BenchLevel &level, const size_t players, const uint32_t ticks)
+{
+    Arena arena = makeBatchArena(level);
+    Arena batchArena = arena;
+    std::vector<Player> reference(
+            players, Player(PLAYER_SPAWN, PLAYER_SIZE,
+                            PlayerAnimator(sf::Vector2f(64, 64), sf::Vector2i(), 0, 0, 10, sf::Vector2i(0, 0))));
+    PlayerBatch batch(players, PLAYER_SPAWN, PLAYER_SIZE);
+
+    const auto differs = [&](const PlayerBatch &other, const size_t i)
+    {
+        const Player &player = reference[i];
+        return player.getPosition().y != other.getPosition(i).y or player.getVelocity() != other.getVelocity(i) or
+               player.getAcceleration() != other.getAcceleration(i) or player.isOnGround() != other.isOnGround(i) or
+               player.isDead() != other.isDead(i);
+    };
+    const auto describe = [&](const PlayerBatch &other, const size_t i)
+    {
+        const Player &player = reference[i];
+        return std::format("y {} vs {}, velocity {} vs {}, acceleration {} vs {}, on ground {} vs {}, dead {} vs {}",
+                           player.getPosition().y, other.getPosition(i).y, player.getVelocity(), other.getVelocity(i),
+                           player.getAcceleration(), other.getAcceleration(i), player.isOnGround(),
+                           other.isOnGround(i), player.isDead(), other.isDead(i));
+    };
+
+    size_t alive = 0;
+    for (uint32_t tick = 0; tick < ticks; ++tick)
+    {
+        for (size_t i = 0; i < players; ++i)
+        {
+            if (const std::optional<bool> jump = getBeatJump(i, tick); jump)
+                *jump ? reference[i].pressJump() : reference[i].releaseJump();
+        }
+        playBeatJumps(batch, 0, players, tick);
+
+        arena.update(TICK);
+        for (Player &player: reference)
+            player.update(arena, TICK);
+        batchArena.update(TICK);
+        batch.update(batchArena, TICK);
+
+        for (size_t i = 0; i < players; ++i)
+        {
+            if (differs(batch, i))
+            {
+                fail(std::format("PlayerBatch::update moved player {} of {} unlike Player on tick {}: {}", i, players,
+                                 tick, describe(batch, i)));
+                return;
+            }
+        }
+        alive += batch.getAliveCount();
+    }
+
+    for (const unsigned threads: {1u, 4u})
+    {
+        Arena simulated = makeBatchArena(level);
+        PlayerBatch threaded(players, PLAYER_SPAWN, PLAYER_SIZE);
+        threaded.simulate(simulated, TICK, ticks, threads, playBeatJumps);
+        for (size_t i = 0; i < players; ++i)
+        {
+            if (differs(threaded, i))
+            {
+                fail(std::format("PlayerBatch::simulate on {} threads left player {} of {} unlike Player after {} "
+                                 "ticks: {}",
+                                 threads, i, players, ticks, describe(threaded, i)));
+                return;
+            }
+        }
+    }
+
+    notes() << std::format("    {} players match Player for {} ticks, {} player ticks alive\n", players, ticks, alive);
+}
+
+void benchPlayerBatch()
+{
+    if (!beginBenchmark("PlayerBatch::update", "one tick of every player of a batch, restarting once all died"))
+        return;
+
+    const BenchLevel &level = getLevels().back();
+    for (const size_t players: {64, 1024})
+    {
+        checkPlayerBatch(level, players, 2400);
+
+        Arena arena = makeBatchArena(level);
+        PlayerBatch batch(players, PLAYER_SPAWN, PLAYER_SIZE);
+
+        // They all start over once everyone died
+        uint32_t tick = 0;
+        measure("PlayerBatch::update", "one thread", players, getIterations(1 << 22, players), 0, [&]
+        {
+            playBeatJumps(batch, 0, players, tick++);
+            arena.update(TICK);
+            batch.update(arena, TICK);
+            const size_t alive = batch.getAliveCount();
+            if (alive == 0)
+            {
+                arena.reset();
+                batch.reset();
+                tick = 0;
+            }
+            return alive;
+        });
+    }
+}
+
+void benchPlayerBatchSimulate()
+{
+    if (!beginBenchmark("PlayerBatch::simulate", "a second of every player of a batch from the start, split over "
+                                                 "threads"))
+        return;
+
+    std::vector<unsigned> threadCounts{1, 2, 4, std::max(1u, std::thread::hardware_concurrency())};
+    std::ranges::sort(threadCounts);
+    threadCounts.erase(std::ranges::unique(threadCounts).begin(), threadCounts.end());
+
+    const BenchLevel &level = getLevels().back();
+    constexpr uint32_t ticks = 240;
+    for (const size_t players: {1024, 8192})
+    {
+        Arena arena = makeBatchArena(level);
+        PlayerBatch batch(players, PLAYER_SPAWN, PLAYER_SIZE);
+        for (const unsigned threads: threadCounts)
+        {
+            measure("PlayerBatch::simulate", std::format("{} thread{}", threads, threads == 1 ? "" : "s"), players,
+                    getIterations(1 << 22, players * ticks), 0, [&]
+            {
+                arena.reset();
+                batch.reset();
+                batch.simulate(arena, TICK, ticks, threads, playBeatJumps);
+                return batch.getAliveCount();
+            });
+        }
+    }
+}
+
+bool parseOptions(const int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--json")
+        {
+            BenchSettings.json = true;
+        }
+        else if (arg == "--filter" and i + 1 < argc)
+        {
+            BenchSettings.filter = argv[++i];
+        }
+        else if (arg == "--repeat" and i + 1 < argc)
+        {
+            BenchSettings.repeat = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "Usage: GeometryDash2Bench [--json] [--filter text] [--repeat count]\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (!parseOptions(argc, argv))
+        return 1;
+    // Only problems are worth printing in between the results
+    slog::SimpleLogger::GlobalLogger()->setMinLogLevel(slog::LogLevel::WARNING);
+
+    benchLayerParser();
+    benchLevelLoading();
+    benchArenaCollision();
+    benchTriangleCollider();
+    benchColliderBatch();
+    benchFromHSL();
+    benchSimulation();
+    benchPlayerBatch();
+    benchPlayerBatchSimulate();
+
+    if (BenchSettings.json)
+        printJson();
+    return Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,39 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include <format>
+#include <string>
+
+#include "game/LevelFile.h"
+#include "simplelogger.hpp"
+
+/* Compiles tiled maps into the binary format the arena can map straight into memory
+ * Usage: LevelCompiler <level.tmx> [more levels...], each output is written next to its map */
+int main(int argc, char *argv[])
+{
+    SL_CAPTURE_EXCEPTIONS();
+    slog::SimpleLogger::GlobalLogger()->setMinLogLevel(slog::LogLevel::INFO);
+
+    if (argc < 2)
+    {
+        SL_LOG_ERROR("Usage: LevelCompiler <level.tmx> [more levels...]");
+        return 1;
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string source = argv[i];
+        const std::string output = LevelData::getCompiledPath(source);
+
+        LevelData level;
+        if (!level.loadFromTmx(source) or !level.saveCompiled(output, source))
+        {
+            SL_LOG_ERROR(std::format("Failed to compile {}", source));
+            ++failed;
+            continue;
+        }
+
+        SL_LOG_INFO(std::format("Compiled {} to {}", source, output));
+    }
+
+    return failed == 0 ? 0 : 1;
+}
@@ -3,488 +3,336 @@
 
 #include <algorithm>
 #include <cmath>
-#include <format>
-#include <iostream>
 #include <ranges>
 
 #include "GeometryDash.h"
+#include "Profiler.h"
 #include "simplelogger.hpp"
-#include "tinyxml2.h"
 
-// From https://doc.mapeditor.org/en/latest/reference/global-tile-ids/#gid-tile-flipping
-constexpr uint32_t FLIPPED_HORIZONTALLY_FLAG = 0x80000000;
-constexpr uint32_t FLIPPED_VERTICALLY_FLAG = 0x40000000;
-constexpr uint32_t FLIPPED_DIAGONALLY_FLAG = 0x20000000;
-constexpr uint32_t ROTATED_HEXAGONAL_120_FLAG = 0x10000000;
-
-#ifndef OS_SEP
-
-#ifdef WIN32
-#define OS_SEP "\\"
-#else
-#define OS_SEP "/"
-#endif
-
-#endif // OS_SEP
-
-std::string getFileFolder(const std::string &filePath)
+namespace
 {
-    std::string path = filePath;
-    if (const size_t lastSlash = path.find_last_of("\\/"); lastSlash != std::string::npos)
-    {
-        path = path.substr(0, lastSlash);
-    }
+// Multiplies the baked white tiles by the tint as they are drawn
+constexpr const char *TINT_SHADER = R"(
+uniform sampler2D texture;
+uniform vec4 tint;
 
-    return path;
+void main()
+{
+    gl_FragColor = texture2D(texture, gl_TexCoord[0].xy) * gl_Color * tint;
 }
+)";
 
-bool Arena::loadFromFile(const std::string &filePath)
+/* Shared by every arena, only the thread that draws uses it. Null where shaders aren't supported */
+sf::Shader *getTintShader()
 {
-    tinyxml2::XMLDocument doc;
-    SL_LOG_DEBUG(std::format("Loading file: {}", filePath));
-    if (doc.LoadFile(filePath.c_str()) != tinyxml2::XML_SUCCESS)
+    static sf::Shader shader;
+    static const bool loaded = [&]
     {
-        SL_LOG_FATAL(std::format("Failed to load file: {}", filePath));
-        return false;
-    }
-
-    tinyxml2::XMLElement *rootNode = doc.RootElement();
-    if (rootNode == nullptr)
-    {
-        SL_LOG_FATAL("Failed to find root node");
-        return false;
-    }
-
-    // Process the nodes
-    if (rootNode->Name() == std::string("map"))
-    {
-        SL_LOG_DEBUG("Loading map");
-
-        if (rootNode->QueryIntAttribute("width", &m_size.x) != tinyxml2::XML_SUCCESS)
+        if (!sf::Shader::isAvailable())
         {
-            SL_LOG_FATAL("Failed to load width of map");
+            SL_LOG_WARNING("Shaders aren't available, the level is drawn without its tint");
             return false;
         }
-        if (rootNode->QueryIntAttribute("height", &m_size.y) != tinyxml2::XML_SUCCESS)
+        if (!shader.loadFromMemory(TINT_SHADER, sf::Shader::Fragment))
         {
-            SL_LOG_FATAL("Failed to load height of map");
+            SL_LOG_ERROR("Failed to load the tint shader, the level is drawn without its tint");
             return false;
         }
-        if (rootNode->QueryIntAttribute("tilewidth", &m_tileSize.x) != tinyxml2::XML_SUCCESS)
-        {
-            SL_LOG_ERROR("Failed to load the Tile Width of map, defaulting to 64");
-            m_tileSize.x = 64;
-        }
-        if (rootNode->QueryIntAttribute("tileheight", &m_tileSize.y) != tinyxml2::XML_SUCCESS)
-        {
-            SL_LOG_ERROR("Failed to load the Tile Height of map, defaulting to 64");
-            m_tileSize.y = 64;
-        }
-    }
-    else
-    {
-        SL_LOG_FATAL(std::format("File: {} does not contain a map", filePath));
-        SL_LOG_DEBUG(std::format("File: {} contains root element {}", filePath, rootNode->Name()));
-        return false;
-    }
 
-    std::vector<TileSet> tileSets;
-    for (const tinyxml2::XMLElement *cNode = rootNode->FirstChildElement(); cNode != nullptr;
-         cNode = cNode->NextSiblingElement())
-    {
-        SL_LOG_DEBUG(std::format("Processing node {}", cNode->Name()));
-        if (cNode->Name() == std::string("tileset"))
-        {
-            TileSet tileSet;
-
-            SL_LOG_DEBUG(std::format("Loading tile set {}", cNode->Attribute("name")));
-
-            const char *nm;
-            if (cNode->QueryStringAttribute("name", &nm) != tinyxml2::XML_SUCCESS)
-            {
-                SL_LOG_ERROR("Failed to load name of tile set, defaulting to empty string");
-                nm = "";
-            }
-            tileSet.name = nm;
-
-            if (cNode->QueryIntAttribute("firstgid", &tileSet.firstGid) != tinyxml2::XML_SUCCESS)
-            {
-                SL_LOG_FATAL(std::format("Failed to load firstgid of tile set {}", tileSet.name));
-                return false;
-            }
-            if (cNode->QueryIntAttribute("tilewidth", &tileSet.tileWidth) != tinyxml2::XML_SUCCESS)
-            {
-                SL_LOG_ERROR(std::format("Failed to load tilewidth of tile set {}, defaulting to 64", tileSet.name));
-                tileSet.tileWidth = 64;
-            }
-            if (cNode->QueryIntAttribute("tileheight", &tileSet.tileHeight) != tinyxml2::XML_SUCCESS)
-            {
-                SL_LOG_ERROR(std::format("Failed to load tileheight of tile set {}, defaulting to 64", tileSet.name));
-                tileSet.tileHeight = 64;
-            }
-            if (cNode->QueryIntAttribute("tilecount", &tileSet.tileCount) != tinyxml2::XML_SUCCESS)
-            {
-                SL_LOG_WARNING("Tilesets with only a single frame are not supported");
-                tileSet.tileCount = 0;
-            }
-            if (cNode->QueryIntAttribute("columns", &tileSet.columnCount) != tinyxml2::XML_SUCCESS)
-            {
-                SL_LOG_WARNING("Tilesets with only a single frame are not supported");
-                tileSet.columnCount = 0;
-            }
-            if (cNode->QueryIntAttribute("padding", &tileSet.padding) != tinyxml2::XML_SUCCESS)
-            {
-                // Ignore
-                tileSet.padding = 0;
-            }
-
-            for (const tinyxml2::XMLElement *tileNode = cNode->FirstChildElement(); tileNode != nullptr;
-                 tileNode = tileNode->NextSiblingElement())
-            {
-                if (tileNode->Name() == std::string("image"))
-                {
-                    tileSet.tiles.push_back(Tile(
-                            sf::Vector2i(tileNode->IntAttribute("width", 0), tileNode->IntAttribute("height", 0))));
-                    const char *src;
-                    if (tileNode->QueryAttribute("source", &src) != tinyxml2::XML_SUCCESS)
-                    {
-                        SL_LOG_ERROR(std::format("Failed to load source of tile set for image in tile set {}",
-                                                 tileSet.name));
-                        src = "";
-                    }
-                    tileSet.tiles.back().texture = src;
-                }
-            }
-
-            tileSets.push_back(std::move(tileSet));
-        }
+        shader.setUniform("texture", sf::Shader::CurrentTexture);
+        return true;
+    }();
+    return loaded ? &shader : nullptr;
+}
+} // namespace
 
-        if (cNode->Name() == std::string("layer"))
-        {
-            SL_LOG_DEBUG(std::format("Loading layer {}", cNode->Attribute("name")));
-            const tinyxml2::XMLElement *data = cNode->FirstChildElement();
-            if (data == nullptr)
-            {
-                SL_LOG_FATAL(std::format("Failed to load data of layer {}", cNode->Attribute("name")));
-                return false;
-            }
-            if (data->Attribute("encoding") != std::string("csv"))
-            {
-                const char *encoding = nullptr;
-                if (data->QueryAttribute("encoding", &encoding) != tinyxml2::XML_SUCCESS)
-                {
-                    SL_LOG_FATAL(std::format("Failed to load encoding of layer {}", cNode->Attribute("name")));
-                }
-                if (encoding)
-                {
-                    SL_LOG_FATAL(
-                            std::format("Unsupported encoding <{}> of layer {}", encoding, cNode->Attribute("name")));
-                }
-                return false;
-            }
-
-            sf::Vector2i tileSize{0, 0};
-            for (const auto &ts: tileSets)
-            {
-                if (ts.tileWidth > tileSize.x)
-                {
-                    tileSize.x = ts.tileWidth;
-                }
-                if (ts.tileHeight > tileSize.y)
-                {
-                    tileSize.y = ts.tileHeight;
-                }
-            }
-            if (!parseLayer(data->GetText(), tileSize))
-            {
-                SL_LOG_FATAL(std::format("Failed to parse layer {}", cNode->Attribute("name")));
-                return false;
-            }
-        }
-    }
+void Arena::setLevel(const std::shared_ptr<const Level> &level)
+{
+    m_level = level ? level : std::make_shared<const Level>();
 
-    if (tileSets.empty())
-    {
-        SL_LOG_FATAL("Failed to load any tile sets");
-        return false;
-    }
-    SL_LOG_DEBUG(std::format("Loaded {}", filePath));
+    const sf::Vector2i size = m_level->getSize();
+    const sf::Vector2i tileSize = m_level->getTileSize();
+    m_viewportSize.x = static_cast<float>(size.x * tileSize.x);
+    m_viewportSize.y = static_cast<float>(size.y * tileSize.y);
+
+    m_animations.resize(m_level->getAnimatedObjects().size());
+    reset();
+}
 
-    std::string folder = getFileFolder(filePath);
-    for (const auto &tileSet: tileSets)
+void Arena::reset()
+{
+    const std::vector<size_t> &animated = m_level->getAnimatedObjects();
+    for (size_t a = 0; a < animated.size(); a++)
     {
-        int i = 0;
-        for (auto iter = tileSet.tiles.begin(); iter != tileSet.tiles.end(); ++i, ++iter)
-        {
-            auto texture = std::make_shared<sf::Texture>();
-            if (!texture->loadFromFile(folder + OS_SEP + iter->texture))
-            {
-                SL_LOG_FATAL(std::format("Failed to load texture {}", folder + OS_SEP + iter->texture));
-                return false;
-            }
-
-            m_textures[i + tileSet.firstGid] = texture;
-        }
+        m_animations[a] = Animation{m_level->getObjects()[animated[a]].getFrame()};
     }
 
-    SL_LOG_DEBUG("Creating world");
-
-    createWorld(tileSets);
+#ifndef NDEBUG
+    m_collisions = 0;
+    m_tested.clear();
+#endif // NDEBUG
 
-    SL_LOG_DEBUG("Created arena");
+    resetPos();
+}
 
-    return true;
+void Arena::resetPos()
+{
+    m_position = m_level->getStartPosition();
+    m_previousPosition = m_position;
+    seekWindow();
 }
 
-void Arena::createWorld(const std::vector<TileSet> &set)
+float Arena::getWindowLeft() const
 {
-    m_viewportSize.x = static_cast<float>(m_size.x * m_tileSize.x);
-    m_viewportSize.y = static_cast<float>(m_size.y * m_tileSize.y);
+    return m_position.x - m_viewportSize.x - static_cast<float>(m_level->getTileSize().x * 2);
+}
 
-    int j = 0;
-    for (const auto &pos: m_map)
-    {
-        if (pos != 0)
-            j++;
-    }
-    m_objects.reserve(j);
+float Arena::getWindowRight() const
+{
+    return m_position.x + m_viewportSize.x + static_cast<float>(m_level->getTileSize().x * 2);
+}
 
-    if (set.empty())
+void Arena::advanceWindow()
+{
+    const float left = getWindowLeft();
+    if (left < m_windowLeft)
     {
-        SL_LOG_FATAL("Failed to load any tile sets");
+        // The arena only scrolls right, anything else needs a full search
+        seekWindow();
         return;
     }
+    m_windowLeft = left;
+
+    const size_t count = m_level->getTileCount();
+    const float right = getWindowRight();
+    while (m_windowFirst < count and m_level->getTilePosition(m_windowFirst).x < left)
+        ++m_windowFirst;
+    m_windowLast = std::max(m_windowLast, m_windowFirst);
+    while (m_windowLast < count and m_level->getTilePosition(m_windowLast).x <= right)
+        ++m_windowLast;
+}
 
-    std::vector<TileSet> nset = set;
-    std::ranges::sort(nset, [](const TileSet &a, const TileSet &b) { return a.firstGid < b.firstGid; });
-    for (int r = m_size.y - 1; r > 0; --r)
-    {
-        for (int c = 0; c < m_size.x; ++c)
-        {
-            uint32_t value = m_map[r * m_size.x + c];
-            if (value == 0)
-                continue;
-
-            const bool flippedHorizontally = (value & FLIPPED_HORIZONTALLY_FLAG) != 0;
-            const bool flippedVertically = (value & FLIPPED_VERTICALLY_FLAG) != 0;
-            const bool flippedDiagonally = (value & FLIPPED_DIAGONALLY_FLAG) != 0;
-            // if (flippedHorizontally and flippedVertically and flippedDiagonally)
-            //     SL_LOGF_DEBUG("flipped horizontally: {}, flipped vertically: {}, flipped diagonally: {}",
-            //                   flippedHorizontally, flippedVertically, flippedDiagonally);
-
-            // Clear the flags
-            value &= ~(FLIPPED_HORIZONTALLY_FLAG | FLIPPED_VERTICALLY_FLAG | FLIPPED_DIAGONALLY_FLAG |
-                       ROTATED_HEXAGONAL_120_FLAG);
-
-            const TileSet *ts = nullptr;
-            for (auto iter = nset.begin(); iter != nset.end(); ++iter)
-            {
-                if (iter + 1 == nset.end() or (value >= iter->firstGid and value < (iter + 1)->firstGid))
-                {
-                    ts = iter.base();
-                    break;
-                }
-            }
-            if (ts == nullptr)
-            {
-                SL_LOGF_FATAL("Failed to find tile set for value {}", value);
-                return;
-            }
-
-            sf::Vector2i frameCount(ts->columnCount, std::ceil(ts->tileCount / ts->columnCount));
-            // SL_LOGF_DEBUG("Frame count for {} is {}x{}", ts->name, frameCount.x, frameCount.y);
-            const int id = ts->firstGid;
-            if (!m_textures.contains(id))
-            {
-                SL_LOG_FATAL("Loaded tile set does not contain a valid image");
-                return;
-            }
-
-            // SL_LOG_DEBUG(std::format("Creating item at location x: {}, y: {} with frame id: {}", c * m_tileSize.x,
-            //                          r * m_tileSize.y, value));
-            m_objects.emplace_back(
-                    m_textures[id],
-                    sf::Vector2f(static_cast<float>(c * m_tileSize.x), static_cast<float>(r * m_tileSize.y)),
-                    sf::Vector2f(m_tileSize), frameCount, sf::Vector2i(ts->padding, ts->padding), value - ts->firstGid);
-            m_objects.back().setFlippedHorizontally(flippedHorizontally);
-            m_objects.back().setFlippedVertically(flippedVertically);
-            m_objects.back().setFlippedDiagonally(flippedDiagonally);
-            // m_objects.back().setOnCollision([]() { SL_LOG_DEBUG("Collision!"); });
-
-            if (ts->name == "Spikes")
-            {
-                m_objects.back().setType(ArenaItemType::Spike);
-            }
-            else if (ts->name == "TinySpikes")
-            {
-                m_objects.back().setType(ArenaItemType::TinySpike);
-            }
-            else if (ts->name == "Default" or ts->name == "SimpleTileSet")
-            {
-                m_objects.back().setType(ArenaItemType::Default);
-            }
-            else
-            {
-                SL_LOGF_WARNING("Unknown object type: {}", ts->name);
-            }
-        }
-    }
+void Arena::seekWindow()
+{
+    m_windowLeft = getWindowLeft();
+    m_windowFirst = m_level->findFirstTile(m_windowLeft);
+    m_windowLast = std::max(m_windowFirst, m_level->findLastTile(getWindowRight()));
+}
+
+std::optional<TileHit> Arena::collidePlayer(const sf::FloatRect &shape)
+{
+    ProfileZone zone("Arena::collidePlayer");
 
-    m_objects.shrink_to_fit();
+    /* There is a potential edge case here not handled where the
+     player collides with 2 tiles in the same frame, in that case it should
+     just collide randomly and should not make a difference to the gameplay */
+    const sf::IntRect cells = m_level->getCellRange(shape, m_position);
+    const sf::FloatRect world{shape.left + m_position.x, shape.top + m_position.y, shape.width, shape.height};
+
+    // Solid blocks fill their cells, every one in the range overlaps the shape
+    std::optional<size_t> hit;
+    m_level->forEachSolid(cells,
+                          [&](const size_t tile)
+                          {
+                              if (!hit or m_level->isVisitedBefore(tile, *hit))
+                                  hit = tile;
+                          });
+    // Candidates come in visiting order, so only the first overlapping one can beat the solid block
+    m_level->forEachCandidate(cells,
+                              [&](const size_t tile)
+                              {
+                                  if (hit and m_level->isVisitedBefore(*hit, tile))
+                                      return false;
+                                  if (!::collides(m_level->getCollider(tile), world))
+                                      return true;
+
+                                  hit = tile;
+                                  return false;
+                              });
+
+    if (!hit)
+        return std::nullopt;
 
-    SL_LOGF_DEBUG("Loaded {} objects", m_objects.size());
+#ifndef NDEBUG
+    m_tested.push_back(*hit);
+#endif // NDEBUG
+    m_level->notifyCollision(*hit);
+    return m_level->getTileHit(*hit);
+}
 
-    resetPos();
+size_t Arena::collidePlayerAll(const sf::FloatRect &shape, std::vector<TileHit> &hits) const
+{
+    const sf::IntRect cells = m_level->getCellRange(shape, m_position);
+    const sf::FloatRect world{shape.left + m_position.x, shape.top + m_position.y, shape.width, shape.height};
+
+    const size_t first = hits.size();
+    m_level->forEachSolid(cells, [&](const size_t tile) { hits.push_back(m_level->getTileHit(tile)); });
+    m_level->forEachCandidate(cells,
+                              [&](const size_t tile)
+                              {
+                                  if (::collides(m_level->getCollider(tile), world))
+                                      hits.push_back(m_level->getTileHit(tile));
+                                  return true;
+                              });
+
+    // Solid blocks come a rectangle at a time, back into the order the cells are visited in
+    std::sort(hits.begin() + static_cast<std::ptrdiff_t>(first), hits.end(),
+              [this](const TileHit &a, const TileHit &b) { return m_level->isVisitedBefore(a.tile, b.tile); });
+    return hits.size() - first;
 }
 
-void Arena::resetPos()
+sf::IntRect Arena::getSweepCells(const sf::FloatRect &shape, const sf::Vector2f &delta) const
 {
-    m_position.x = 0;
-    SL_LOG_DEBUG("Finding starting Y position");
-    for (int i = 0; i < m_size.x * m_size.y; i += m_size.x)
-    {
-        if (m_map[i] != 0)
-        {
-            SL_LOG_DEBUG(std::format("Found first item at y position {}", i / m_size.x));
-            m_position.y = static_cast<float>(static_cast<double>(i) / static_cast<double>(m_size.x) * m_tileSize.x -
-                                              m_tileSize.x * 10);
-            SL_LOG_DEBUG(std::format("Starting at y location {}", m_position.y));
-            break;
-        }
-    }
+    // Every cell the shape passes through on the way
+    const sf::FloatRect swept{std::min(shape.left, shape.left + delta.x), std::min(shape.top, shape.top + delta.y),
+                              shape.width + std::abs(delta.x), shape.height + std::abs(delta.y)};
+    return m_level->getCellRange(swept, m_position);
 }
 
-bool Arena::parseLayer(const std::string &layer, sf::Vector2i tileSize)
+std::optional<TileSweep> Arena::sweepShape(const sf::FloatRect &shape, const sf::Vector2f &delta,
+                                           const std::span<const size_t> candidates,
+                                           const ColliderBatch &colliders) const
 {
-    m_map.resize(m_size.x * m_size.y);
-    for (auto &pos: m_map)
-    {
-        pos = 0;
-    }
+    SL_ASSERT(candidates.size() == colliders.size(), "Every candidate needs its collider");
 
-    int pos = 0;
-    std::string cSquare;
-    for (const char i: layer)
-    {
-        if (pos >= m_size.x * m_size.y)
-        {
-            SL_LOG_FATAL("Layer is too large");
-            return false;
-        }
+    const sf::IntRect cells = getSweepCells(shape, delta);
+    const sf::FloatRect world{shape.left + m_position.x, shape.top + m_position.y, shape.width, shape.height};
 
-        if (i == ',')
-        {
-            try
-            {
-                m_map[pos] = std::stoll(cSquare);
-            }
-            catch (const std::out_of_range &)
-            {
-                SL_LOG_FATAL("Failed to parse layer due to out of range number");
-                return false;
-            }
-            cSquare.clear();
-            ++pos;
+    // Per thread so any number of them can sweep the same arena
+    thread_local std::vector<float> times;
+    thread_local std::vector<uint8_t> axes;
+    times.resize(colliders.size());
+    axes.resize(colliders.size());
+    sweepBatch(colliders, world, delta, times, axes);
 
+    std::optional<TileSweep> first = m_level->sweepSolid(cells, world, delta);
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        // Shared candidates can come from a bigger range
+        const size_t tile = candidates[i];
+        if (times[i] == INFINITY or !cells.contains(m_level->getTileCell(tile)))
             continue;
-        }
-        if (i == '\n')
-        {
-            continue;
-        }
 
-        cSquare += i;
+        if (!first or times[i] < first->sweep.time or
+            (times[i] == first->sweep.time and m_level->isVisitedBefore(tile, first->hit.tile)))
+            first = TileSweep{m_level->getTileHit(tile), {times[i], colliders.getSweepNormal(i, axes[i])}};
     }
 
-    if (pos != m_size.x * m_size.y - 1)
-    {
-        SL_LOG_WARNING("Layer is smaller than expected");
-        SL_LOG_DEBUG(std::format("Expected: {}, Got: {}", m_size.x * m_size.y, pos));
-    }
-
-    return true;
+    return first;
 }
 
-ArenaItem *Arena::collidePlayer(const sf::FloatRect &shape)
+std::optional<TileSweep> Arena::sweepPlayer(const sf::FloatRect &shape, const sf::Vector2f &delta)
 {
-    /* There is a potential edge case here not handled where the
-     player collides with 2 tiles in the same frame, in that case it should
-     just collide randomly and should not make a difference to the gameplay */
-#ifndef NDEBUG
-    m_collisions = 0;
-#endif // NDEBUG
-    for (auto &arenaItem: m_objects)
-    {
-        // Only collide items in the viewport
-        if (arenaItem.getPosition().x > m_position.x + m_viewportSize.x / 2 or
-            arenaItem.getPosition().x < m_position.x - m_viewportSize.x)
-            continue;
-        if (arenaItem.getPosition().y > m_position.y + m_viewportSize.y or
-            arenaItem.getPosition().y < m_position.y - m_viewportSize.y)
-            continue;
+    ProfileZone zone("Arena::sweepPlayer");
+
+    m_candidates.clear();
+    m_colliders.clear();
+    m_level->forEachCandidate(getSweepCells(shape, delta),
+                              [this](const size_t tile)
+                              {
+                                  m_candidates.push_back(tile);
+                                  m_level->addCollider(tile, m_colliders);
+                                  return true;
+                              });
+    std::optional<TileSweep> first = sweepShape(shape, delta, m_candidates, m_colliders);
 
 #ifndef NDEBUG
-        ++m_collisions;
+    m_collisions = m_candidates.size();
+    if (first)
+        m_tested.push_back(first->hit.tile);
 #endif // NDEBUG
-        if (arenaItem.collides(shape))
-        {
-            arenaItem.setRelativePosition(m_position);
-            return &arenaItem;
-        }
-    }
 
-    return nullptr;
+    if (first)
+        m_level->notifyCollision(first->hit.tile);
+    return first;
 }
 
-void Arena::update()
+void Arena::update(const float dt)
 {
-    m_position += m_scrollSpeed * GeometryDash::getInstance().getDeltaTime().asSeconds();
+    ProfileZone zone("Arena::update");
 
-    for (auto &arenaItem: m_objects)
+    m_previousPosition = m_position;
+    m_position += m_scrollSpeed * dt;
+    advanceWindow();
+
+    // Static items have nothing to update, only animations in the viewport need to advance
+    const std::vector<size_t> &animated = m_level->getAnimatedObjects();
+    const std::vector<size_t> &tiles = m_level->getObjectTiles();
+    for (size_t a = 0; a < animated.size(); ++a)
     {
-        arenaItem.setRelativePosition(m_position);
-        // Only update items that are in the viewport
-        // if (arenaItem.getPosition().x > m_position.x + m_viewportSize.x + static_cast<float>(m_tileSize.x * 2) or
-        //     arenaItem.getPosition().x < m_position.x - m_viewportSize.x - static_cast<float>(m_tileSize.x * 2))
-        //     continue;
-        // if (arenaItem.getPosition().y > m_position.y + m_viewportSize.y + static_cast<float>(m_tileSize.y * 2) or
-        //     arenaItem.getPosition().y < m_position.y - m_viewportSize.y - static_cast<float>(m_tileSize.y * 2))
-        //     continue;
-
-        arenaItem.update();
+        const size_t tile = tiles[animated[a]];
+        if (tile >= m_windowFirst and tile < m_windowLast)
+            m_level->getObjects()[animated[a]].animate(m_animations[a].frame, m_animations[a].timer, dt);
     }
 }
 
-void Arena::render(const sf::Vector2f &cameraPos, sf::Color tint)
+void Arena::render(const sf::Vector2f &cameraPos, sf::Color tint, const float alpha)
 {
+    sf::RenderWindow &window = GeometryDash::getInstance().getWindow().getWindow();
+    const sf::Vector2f position = m_previousPosition + (m_position - m_previousPosition) * alpha;
+
+    // Move the baked world into place rather than every tile
+    sf::RenderStates states;
+    states.transform.translate(cameraPos - position);
+
+    // The baked tiles stay white, the tint is a uniform so changing it every frame costs nothing
+    sf::RenderStates staticStates = states;
+    if (sf::Shader *shader = getTintShader(); shader != nullptr)
+    {
+        shader->setUniform("tint", sf::Glsl::Vec4(tint));
+        staticStates.shader = shader;
+    }
+    [[maybe_unused]] const size_t rendered = m_level->renderStatic(getWindowLeft(), getWindowRight(), staticStates);
 #ifndef NDEBUG
-    m_rendered = 0;
+    m_rendered = rendered;
 #endif // NDEBUG
-    for (auto &arenaItem: m_objects)
+
+    for (auto &batch: m_batches)
     {
+        batch.vertices.clear();
+    }
 
-        // Only render items that are in the viewport
-        if (arenaItem.getPosition().x > m_position.x + m_viewportSize.x + static_cast<float>(m_tileSize.x * 2) or
-            arenaItem.getPosition().x < m_position.x - m_viewportSize.x - static_cast<float>(m_tileSize.x * 2))
-            continue;
-        if (arenaItem.getPosition().y > m_position.y + m_viewportSize.y + static_cast<float>(m_tileSize.y * 2) or
-            arenaItem.getPosition().y < m_position.y - m_viewportSize.y - static_cast<float>(m_tileSize.y * 2))
+    const std::vector<ArenaItem> &objects = m_level->getObjects();
+    const std::vector<size_t> &animated = m_level->getAnimatedObjects();
+    const std::vector<size_t> &tiles = m_level->getObjectTiles();
+    for (size_t a = 0; a < animated.size(); ++a)
+    {
+        const size_t i = animated[a];
+        if (tiles[i] < m_windowFirst or tiles[i] >= m_windowLast)
             continue;
 
 #ifndef NDEBUG
         ++m_rendered;
 #endif // NDEBUG
 
-        arenaItem.setRelativePosition(m_position);
-        arenaItem.render(cameraPos, tint);
+        objects[i].batch(getTextureBatch(m_batches, objects[i].getTexture()), sf::Vector2f(0, 0), tint,
+                         m_animations[a].frame);
+    }
+
+    for (const auto &batch: m_batches)
+    {
+        if (batch.vertices.getVertexCount() == 0)
+            continue;
+
+        states.texture = batch.texture;
+        window.draw(batch.vertices, states);
     }
+
+#ifndef NDEBUG
+    for (size_t i = m_windowFirst; i < m_windowLast; ++i)
+    {
+        const bool tested = std::ranges::find(m_tested, i) != m_tested.end();
+        m_level->renderCollider(i, cameraPos, position, tested);
+    }
+    m_tested.clear();
+#endif // NDEBUG
 }
 
-ArenaItem *Arena::getObject(uint64_t id)
+const ArenaItem *Arena::getObject(const uint64_t id) const
 {
-    const auto found =
-            std::ranges::find_if(m_objects, [id](const ArenaItem &arenaItem) { return arenaItem.getId() == id; });
-    if (found == m_objects.end())
+    const auto found = std::ranges::find_if(m_level->getObjects(),
+                                            [id](const ArenaItem &arenaItem) { return arenaItem.getId() == id; });
+    if (found == m_level->getObjects().end())
     {
         return nullptr;
     }
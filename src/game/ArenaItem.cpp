@@ -1,6 +1,7 @@
 /* Created by Matthew Brown on 6/20/2024 */
 #include "game/ArenaItem.h"
 
+#include <array>
 #include <cmath>
 #include <format>
 
@@ -9,102 +10,95 @@
 
 uint64_t ArenaItem::s_idCounter = 0;
 
-ArenaItem::ArenaItem(const std::shared_ptr<sf::Texture> &texture, const sf::Vector2f &position,
-                     const sf::Vector2f &size, const sf::Vector2i &frameCount, const sf::Vector2i &padding,
-                     const int frame) :
-    m_id(s_idCounter++), m_sprite(*texture), m_texture(texture), m_position(position), m_size(size),
-    m_texFrameCount(frameCount), m_minFrame(0), m_maxFrame(0), m_frameRate(0), m_currentFrame(frame), m_padding(padding)
+void batchTile(sf::VertexArray &vertices, const sf::Vector2f &position, const sf::Vector2f &size,
+               const sf::IntRect &textureRect, const uint8_t flips, const sf::Color tint)
 {
-}
+    const sf::FloatRect rect{textureRect};
 
-void ArenaItem::regenCollider()
-{
-    enum Direction
+    // Corners in the order top left, top right, bottom right, bottom left
+    const std::array<sf::Vector2f, 4> corners{sf::Vector2f(0, 0), sf::Vector2f(1, 0), sf::Vector2f(1, 1),
+                                              sf::Vector2f(0, 1)};
+    std::array<sf::Vertex, 4> quad;
+    for (size_t i = 0; i < corners.size(); ++i)
     {
-        LEFT,
-        RIGHT,
-        UP,
-        DOWN
-    };
-
-    Direction d = UP;
-    if (m_currentFrame == 0)
-        d = UP;
-    else if (m_currentFrame == 1)
-        d = DOWN;
-    else if (m_currentFrame == 2)
-        d = LEFT;
-    else if (m_currentFrame == 3)
-        d = RIGHT;
+        // Tiled applies the diagonal flip first, then the horizontal and vertical flips
+        sf::Vector2f uv = corners[i];
+        if (flips & TILE_FLIPPED_HORIZONTALLY)
+            uv.x = 1 - uv.x;
+        if (flips & TILE_FLIPPED_VERTICALLY)
+            uv.y = 1 - uv.y;
+        if (flips & TILE_FLIPPED_DIAGONALLY)
+            std::swap(uv.x, uv.y);
+
+        quad[i].position = position + sf::Vector2f(corners[i].x * size.x, corners[i].y * size.y);
+        quad[i].texCoords = sf::Vector2f(rect.left + uv.x * rect.width, rect.top + uv.y * rect.height);
+        quad[i].color = tint;
+    }
 
-    // Deal with flipping - On second thought, I'm not going to bother
-    // if (m_flippedHorizontally and d == UP or m_flippedHorizontally and d == DOWN)
-    //     d = (d == DOWN) ? UP : DOWN;
-    // if (m_flippedVertically and d == LEFT or m_flippedVertically and d == RIGHT)
-    //     d = (d == RIGHT) ? LEFT : RIGHT;
+    vertices.append(quad[0]);
+    vertices.append(quad[1]);
+    vertices.append(quad[2]);
+    vertices.append(quad[0]);
+    vertices.append(quad[2]);
+    vertices.append(quad[3]);
+}
 
-    if (m_type == ArenaItemType::Spike)
+void renderTileCollider([[maybe_unused]] const ArenaItemType type, [[maybe_unused]] const int frame,
+                        [[maybe_unused]] const sf::Vector2f &position, [[maybe_unused]] const sf::Vector2f &size,
+                        [[maybe_unused]] const bool collided)
+{
+#ifndef NDEBUG
+    if (GeometryDash::RenderCollisionShapes)
     {
-        sf::Vector2f leftPoint, rightPoint, topPoint;
-        switch (d)
+        if (type == ArenaItemType::TinySpike or type == ArenaItemType::Spike)
         {
-            case LEFT:
-                leftPoint = sf::Vector2f(m_position.x, m_position.y + (m_size.y / 2));
-                rightPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y + m_size.y);
-                topPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y);
-                break;
-            case RIGHT:
-                leftPoint = sf::Vector2f(m_position.x, m_position.y + m_size.y);
-                rightPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y + (m_size.y / 2));
-                topPoint = sf::Vector2f(m_position.x, m_position.y);
-                break;
-            case UP:
-                leftPoint = sf::Vector2f(m_position.x, m_position.y + m_size.y);
-                rightPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y + m_size.y);
-                topPoint = sf::Vector2f(m_position.x + (m_size.x / 2), m_position.y);
-                break;
-            case DOWN:
-                leftPoint = sf::Vector2f(m_position.x, m_position.y);
-                rightPoint = sf::Vector2f(m_position.x + (m_size.x / 2), m_position.y + m_size.y);
-                topPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y);
-                break;
+            const TriangleCollider collider =
+                    type == ArenaItemType::Spike ? TileCollider<ArenaItemType::Spike>::make(frame, position, size)
+                                                 : TileCollider<ArenaItemType::TinySpike>::make(frame, position, size);
+            sf::ConvexShape shape(3);
+            shape.setPoint(0, collider.getLeftPoint());
+            shape.setPoint(1, collider.getRightPoint());
+            shape.setPoint(2, collider.getTopPoint());
+            if (collided)
+            {
+                shape.setFillColor(sf::Color(255, 40, 40, 150));
+            }
+            else
+            {
+                shape.setFillColor(sf::Color(20, 20, 20, 20));
+            }
+            shape.setOutlineColor(sf::Color::Blue);
+            shape.setOutlineThickness(1);
+            GeometryDash::getInstance().getWindow().getWindow().draw(shape);
         }
-        m_collision = std::make_shared<TriangleCollider>(leftPoint, rightPoint, topPoint);
-    }
-    else if (m_type == ArenaItemType::TinySpike)
-    {
-        sf::Vector2f leftPoint, rightPoint, topPoint;
-        switch (d)
+        else
         {
-            case LEFT:
-                leftPoint = sf::Vector2f(m_position.x + (m_size.x / 2), m_position.y + (m_size.y / 2));
-                rightPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y + m_size.y);
-                topPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y);
-                break;
-            case RIGHT:
-                leftPoint = sf::Vector2f(m_position.x, m_position.y + m_size.y);
-                rightPoint = sf::Vector2f(m_position.x + (m_size.x / 2), m_position.y + (m_size.y / 2));
-                topPoint = sf::Vector2f(m_position.x, m_position.y);
-                break;
-            case UP:
-                leftPoint = sf::Vector2f(m_position.x, m_position.y + m_size.y);
-                rightPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y + m_size.y);
-                topPoint = sf::Vector2f(m_position.x + (m_size.x / 2), m_position.y + (m_size.y / 2));
-                break;
-            case DOWN:
-                leftPoint = sf::Vector2f(m_position.x, m_position.y);
-                rightPoint = sf::Vector2f(m_position.x + m_size.x, m_position.y);
-                topPoint = sf::Vector2f(m_position.x + (m_size.x / 2), m_position.y + (m_size.y / 2));
-                break;
+            sf::RectangleShape shape(size);
+            shape.setPosition(position);
+            shape.setFillColor(sf::Color::Transparent);
+            if (collided)
+            {
+                shape.setFillColor(sf::Color(255, 0, 0, 100));
+            }
+            shape.setOutlineColor(sf::Color::Blue);
+            shape.setOutlineThickness(1);
+            GeometryDash::getInstance().getWindow().getWindow().draw(shape);
         }
-        m_collision = std::make_shared<TriangleCollider>(leftPoint, rightPoint, topPoint);
-    }
-    else
-    {
-        m_collision = std::make_shared<RectangleCollider>(m_position, m_size);
     }
+#endif // NDEBUG
 }
 
+ArenaItem::ArenaItem(const std::shared_ptr<sf::Texture> &texture, const sf::Vector2f &position,
+                     const sf::Vector2f &size, const sf::Vector2i &frameCount, const sf::Vector2i &padding,
+                     const int frame) :
+    m_id(s_idCounter++), m_texture(texture), m_position(position), m_size(size), m_texFrameCount(frameCount),
+    m_minFrame(0), m_maxFrame(0), m_frameRate(0), m_frame(frame), m_padding(padding),
+    m_collider(makeTileCollider(m_type, frame, position, size))
+{
+}
+
+void ArenaItem::regenCollider() { m_collider = makeTileCollider(m_type, m_frame, m_position, m_size); }
+
 void ArenaItem::setType(const ArenaItemType type)
 {
     m_type = type;
@@ -124,159 +118,42 @@ void ArenaItem::setAnimation(const int minFrame, const int maxFrame, const int f
     m_frameRate = frameRate;
 }
 
-void ArenaItem::setColliderPos()
+void ArenaItem::animate(int &frame, double &timer, const float dt) const
 {
-    m_collision->setPosition(m_sprite.getPosition());
-
-    if (m_type == ArenaItemType::TinySpike)
+    if (isAnimated())
     {
-        if (m_currentFrame == 0) // Up
+        timer += dt;
+        if (timer >= 1.0 / m_frameRate)
         {
-            m_collision->setPosition(m_sprite.getPosition() + sf::Vector2f(0, m_size.y / 2));
-        }
-        if (m_currentFrame == 1) // Down
-        {
-            m_collision->setPosition(m_sprite.getPosition() + sf::Vector2f(0, m_size.y / 2));
-        }
-        if (m_currentFrame == 2) // Left
-        {
-            m_collision->setPosition(m_sprite.getPosition() + sf::Vector2f(m_size.x / 2, 0));
-        }
-    }
-}
-
-bool ArenaItem::collides(const sf::FloatRect &shape)
-{
-#ifndef NDEBUG
-    m_collidedThisFrame = true;
-#endif // NDEBUG
-
-    m_sprite.setScale(1, 1);
-    m_sprite.setRotation(0);
-    m_sprite.setPosition(m_position - m_relativePosition);
-
-    setColliderPos();
-    SL_ASSERT(m_collision != nullptr, "No collider for this arena item");
-    if (!m_collision)
-        return false;
-
-    if (m_collision->collides(shape))
-    {
-        if (m_onCollision != nullptr)
-        {
-            m_onCollision();
-        }
-
-        return true;
-    }
-
-    return false;
-}
-
-void ArenaItem::update()
-{
-    if (m_texFrameCount.x * m_texFrameCount.y > 1 and m_frameRate > 0 and m_minFrame != m_maxFrame)
-    {
-        m_dtCounter += GeometryDash::getInstance().getDeltaTime().asSeconds();
-        if (m_dtCounter >= 1.0 / m_frameRate)
-        {
-            m_currentFrame++;
-            if (m_currentFrame >= (m_texFrameCount.x * m_texFrameCount.y) or m_currentFrame > m_maxFrame)
+            timer -= 1.0 / m_frameRate;
+            frame++;
+            if (frame >= (m_texFrameCount.x * m_texFrameCount.y) or frame > m_maxFrame)
             {
-                m_currentFrame = m_minFrame;
+                frame = m_minFrame;
             }
         }
     }
 }
 
-void ArenaItem::render(const sf::Vector2f &cameraPos, sf::Color tint)
+sf::IntRect ArenaItem::getTextureRect(const int currentFrame) const
 {
-    // SL_LOG_DEBUG(std::format("Rendering item at location ({}, {})", m_position.x - m_relativePosition.x,
-    //                          m_position.y - m_relativePosition.y));
-    m_sprite.setPosition(m_position - m_relativePosition + cameraPos);
-    m_sprite.setTexture(*m_texture);
-
-    m_sprite.setColor(tint);
-
-    const sf::Vector2i frame(m_currentFrame % m_texFrameCount.x, std::floor(m_currentFrame / m_texFrameCount.x));
-    const sf::IntRect rect{sf::Vector2i(frame.x * static_cast<int>(m_size.x), frame.y * static_cast<int>(m_size.y)) +
-                                   sf::Vector2i(m_padding.x * frame.x, m_padding.y * frame.y),
-                           sf::Vector2i(static_cast<int>(m_size.x), static_cast<int>(m_size.y))};
+    const sf::Vector2i frame(currentFrame % m_texFrameCount.x, std::floor(currentFrame / m_texFrameCount.x));
+    return {m_textureOrigin +
+                    sf::Vector2i(frame.x * static_cast<int>(m_size.x), frame.y * static_cast<int>(m_size.y)) +
+                    sf::Vector2i(m_padding.x * frame.x, m_padding.y * frame.y),
+            sf::Vector2i(static_cast<int>(m_size.x), static_cast<int>(m_size.y))};
+}
 
-    float scaleX = 1;
-    float scaleY = 1;
+void ArenaItem::batch(sf::VertexArray &vertices, const sf::Vector2f &offset, const sf::Color tint,
+                      const int frame) const
+{
+    uint8_t flips = 0;
+    if (m_flippedHorizontally)
+        flips |= TILE_FLIPPED_HORIZONTALLY;
+    if (m_flippedVertically)
+        flips |= TILE_FLIPPED_VERTICALLY;
     if (m_flippedDiagonally)
-    {
-        // Tiled is weird.
-        m_sprite.setRotation(-90);
-        m_sprite.setPosition(m_sprite.getPosition() + sf::Vector2f(m_size.x, 0));
-
-        if (m_flippedHorizontally)
-        {
-            scaleX = -1;
-            m_sprite.setPosition(m_sprite.getPosition() + sf::Vector2f(-m_size.x, 0));
-        }
-        if (m_flippedVertically)
-        {
-            scaleY = -1;
-            m_sprite.setPosition(m_sprite.getPosition() + sf::Vector2f(0, m_size.y));
-        }
-    }
-    else
-    {
-        if (m_flippedHorizontally)
-        {
-            scaleX = -1;
-            m_sprite.setPosition(m_sprite.getPosition() + sf::Vector2f(m_size.x, 0));
-        }
-        if (m_flippedVertically)
-        {
-            scaleY = -1;
-            m_sprite.setPosition(m_sprite.getPosition() + sf::Vector2f(0, m_size.y));
-        }
-    }
-    m_sprite.setScale(scaleX, scaleY);
-
-    m_sprite.setTextureRect(rect);
-
-    GeometryDash::getInstance().getWindow().getWindow().draw(m_sprite);
+        flips |= TILE_FLIPPED_DIAGONALLY;
 
-#ifndef NDEBUG
-    if (GeometryDash::RenderCollisionShapes)
-    {
-        if (m_type == ArenaItemType::TinySpike or m_type == ArenaItemType::Spike)
-        {
-            setColliderPos();
-            sf::ConvexShape shape(3);
-            shape.setPoint(0, std::dynamic_pointer_cast<TriangleCollider>(m_collision)->getLeftPoint());
-            shape.setPoint(1, std::dynamic_pointer_cast<TriangleCollider>(m_collision)->getRightPoint());
-            shape.setPoint(2, std::dynamic_pointer_cast<TriangleCollider>(m_collision)->getTopPoint());
-            if (m_collidedThisFrame)
-            {
-                shape.setFillColor(sf::Color(255, 40, 40, 150));
-            }
-            else
-            {
-                shape.setFillColor(sf::Color(20, 20, 20, 20));
-            }
-            shape.setOutlineColor(sf::Color::Blue);
-            shape.setOutlineThickness(1);
-            GeometryDash::getInstance().getWindow().getWindow().draw(shape);
-        }
-        else
-        {
-            sf::RectangleShape shape(m_size);
-            shape.setPosition(m_position - m_relativePosition + cameraPos);
-            shape.setFillColor(sf::Color::Transparent);
-            if (m_collidedThisFrame)
-            {
-                shape.setFillColor(sf::Color(255, 0, 0, 100));
-            }
-            shape.setOutlineColor(sf::Color::Blue);
-            shape.setOutlineThickness(1);
-            GeometryDash::getInstance().getWindow().getWindow().draw(shape);
-        }
-    }
-    m_collidedThisFrame = false;
-#endif // NDEBUG
+    batchTile(vertices, m_position + offset, m_size, getTextureRect(frame), flips, tint);
 }
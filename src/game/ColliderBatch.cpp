@@ -0,0 +1,369 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "game/ColliderBatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simplelogger.hpp"
+
+#if defined(__AVX2__)
+#define GD_COLLIDE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#define GD_COLLIDE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Edges that can't separate anything, a * x + b * y + c is always 1 which is between 0 and the apex
+constexpr float NEUTRAL_EDGE_C = 1;
+constexpr float NEUTRAL_EDGE_APEX = 2;
+
+void ColliderBatch::clear()
+{
+    m_left.clear();
+    m_top.clear();
+    m_right.clear();
+    m_bottom.clear();
+    for (auto &edges: m_edges)
+    {
+        edges.a.clear();
+        edges.b.clear();
+        edges.c.clear();
+        edges.apex.clear();
+    }
+}
+
+void ColliderBatch::reserve(const size_t count)
+{
+    m_left.reserve(count);
+    m_top.reserve(count);
+    m_right.reserve(count);
+    m_bottom.reserve(count);
+    for (auto &edges: m_edges)
+    {
+        edges.a.reserve(count);
+        edges.b.reserve(count);
+        edges.c.reserve(count);
+        edges.apex.reserve(count);
+    }
+}
+
+void ColliderBatch::addBounds(const sf::FloatRect &bounds)
+{
+    // sf::Rect allows negative sizes, the kernels don't
+    m_left.push_back(std::min(bounds.left, bounds.left + bounds.width));
+    m_top.push_back(std::min(bounds.top, bounds.top + bounds.height));
+    m_right.push_back(std::max(bounds.left, bounds.left + bounds.width));
+    m_bottom.push_back(std::max(bounds.top, bounds.top + bounds.height));
+}
+
+void ColliderBatch::add(const RectangleCollider &collider)
+{
+    addBounds(collider.getShape());
+    for (auto &edges: m_edges)
+    {
+        edges.a.push_back(0);
+        edges.b.push_back(0);
+        edges.c.push_back(NEUTRAL_EDGE_C);
+        edges.apex.push_back(NEUTRAL_EDGE_APEX);
+    }
+}
+
+void ColliderBatch::add(const TriangleCollider &collider)
+{
+    addBounds(collider.getBounds());
+    for (size_t e = 0; e < m_edges.size(); ++e)
+    {
+        const TriangleCollider::Edge &edge = collider.getEdges()[e];
+        m_edges[e].a.push_back(edge.a);
+        m_edges[e].b.push_back(edge.b);
+        m_edges[e].c.push_back(edge.c);
+        m_edges[e].apex.push_back(edge.apex);
+    }
+}
+
+void ColliderBatch::add(const Collider &collider)
+{
+    std::visit([this](const auto &value) { add(value); }, collider);
+}
+
+sf::Vector2f ColliderBatch::getSweepNormal(const size_t collider, const uint8_t axis) const
+{
+    switch (axis)
+    {
+        case 0:
+            return {-1, 0};
+        case 1:
+            return {1, 0};
+        case 2:
+            return {0, -1};
+        case 3:
+            return {0, 1};
+        case NO_AXIS:
+            return {0, 0};
+        default:
+            break;
+    }
+
+    // The same sums as TriangleCollider::sweep, the first side of an edge faces against its normal
+    const Edges &edges = m_edges[(axis - BOUNDS_AXES) / 2];
+    const float length = std::hypot(edges.a[collider], edges.b[collider]);
+    const sf::Vector2f normal(edges.a[collider] / length, edges.b[collider] / length);
+    return (axis - BOUNDS_AXES) % 2 == 0 ? -normal : normal;
+}
+
+void ColliderBatch::sweepScalar(const sf::FloatRect &shape, const sf::Vector2f &delta, const size_t first,
+                                const std::span<float> times, const std::span<uint8_t> axes) const
+{
+    const float shapeLeft = shape.left;
+    const float shapeTop = shape.top;
+    const float shapeRight = shape.left + shape.width;
+    const float shapeBottom = shape.top + shape.height;
+
+    for (size_t i = first; i < size(); ++i)
+    {
+        // The same steps in the same order as the SweepWindow the colliders use
+        float enter = 0;
+        float exit = 1;
+        uint8_t axis = NO_AXIS;
+        bool open = true;
+        const auto keep = [&](const float value, const float rate, const uint8_t side)
+        {
+            if (rate == 0)
+            {
+                if (value <= 0)
+                    open = false;
+                return;
+            }
+
+            const float t = -value / rate;
+            if (rate > 0)
+            {
+                if (t > enter)
+                {
+                    enter = t;
+                    axis = side;
+                }
+            }
+            else
+            {
+                exit = std::min(exit, t);
+            }
+        };
+
+        keep(shapeRight - m_left[i], delta.x, 0);
+        keep(m_right[i] - shapeLeft, -delta.x, 1);
+        keep(shapeBottom - m_top[i], delta.y, 2);
+        keep(m_bottom[i] - shapeTop, -delta.y, 3);
+        for (uint8_t e = 0; e < m_edges.size(); ++e)
+        {
+            const Edges &edges = m_edges[e];
+            const float a = edges.a[i];
+            const float b = edges.b[i];
+            const float high = a * (a > 0 ? shapeRight : shapeLeft) + b * (b > 0 ? shapeBottom : shapeTop) + edges.c[i];
+            const float low = a * (a > 0 ? shapeLeft : shapeRight) + b * (b > 0 ? shapeTop : shapeBottom) + edges.c[i];
+            const float rate = a * delta.x + b * delta.y;
+            keep(high, rate, BOUNDS_AXES + e * 2);
+            keep(edges.apex[i] - low, -rate, BOUNDS_AXES + e * 2 + 1);
+        }
+
+        // Shapes that only touch don't collide, so the window has to be longer than an instant
+        times[i] = open and !(enter >= exit) ? enter : INFINITY;
+        axes[i] = axis;
+    }
+}
+
+void sweepBatchScalar(const ColliderBatch &batch, const sf::FloatRect &shape, const sf::Vector2f &delta,
+                      const std::span<float> times, const std::span<uint8_t> axes)
+{
+    SL_ASSERT(times.size() >= batch.size() and axes.size() >= batch.size(),
+              "Sweep results are too small for the batch");
+    batch.sweepScalar(shape, delta, 0, times, axes);
+}
+
+#if defined(GD_COLLIDE_AVX2)
+
+const char *getSweepBatchPath() { return "AVX2"; }
+
+void sweepBatch(const ColliderBatch &batch, const sf::FloatRect &shape, const sf::Vector2f &delta,
+                const std::span<float> times, const std::span<uint8_t> axes)
+{
+    SL_ASSERT(times.size() >= batch.size() and axes.size() >= batch.size(),
+              "Sweep results are too small for the batch");
+
+    const __m256 shapeLeft = _mm256_set1_ps(shape.left);
+    const __m256 shapeTop = _mm256_set1_ps(shape.top);
+    const __m256 shapeRight = _mm256_set1_ps(shape.left + shape.width);
+    const __m256 shapeBottom = _mm256_set1_ps(shape.top + shape.height);
+    const __m256 deltaX = _mm256_set1_ps(delta.x);
+    const __m256 deltaY = _mm256_set1_ps(delta.y);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 miss = _mm256_set1_ps(INFINITY);
+
+    constexpr size_t lanes = 8;
+    size_t i = 0;
+    for (; i + lanes <= batch.size(); i += lanes)
+    {
+        __m256 enter = zero;
+        __m256 exit = _mm256_set1_ps(1);
+        __m256 axis = _mm256_set1_ps(ColliderBatch::NO_AXIS);
+        __m256 closed = zero;
+        // SweepWindow::keep for every lane, a rate of 0 can only close the window
+        const auto keep = [&](const __m256 value, const __m256 rate, const float side)
+        {
+            const __m256 t = _mm256_div_ps(_mm256_xor_ps(value, sign), rate);
+            const __m256 entering = _mm256_and_ps(_mm256_cmp_ps(rate, zero, _CMP_GT_OQ),
+                                                  _mm256_cmp_ps(t, enter, _CMP_GT_OQ));
+            enter = _mm256_blendv_ps(enter, t, entering);
+            axis = _mm256_blendv_ps(axis, _mm256_set1_ps(side), entering);
+            exit = _mm256_blendv_ps(exit, _mm256_min_ps(t, exit), _mm256_cmp_ps(rate, zero, _CMP_LT_OQ));
+            closed = _mm256_or_ps(closed, _mm256_and_ps(_mm256_cmp_ps(rate, zero, _CMP_EQ_OQ),
+                                                        _mm256_cmp_ps(value, zero, _CMP_LE_OQ)));
+        };
+        const auto missed = [&]
+        { return _mm256_or_ps(closed, _mm256_cmp_ps(enter, exit, _CMP_GE_OQ)); };
+
+        keep(_mm256_sub_ps(shapeRight, _mm256_loadu_ps(&batch.m_left[i])), deltaX, 0);
+        keep(_mm256_sub_ps(_mm256_loadu_ps(&batch.m_right[i]), shapeLeft), _mm256_xor_ps(deltaX, sign), 1);
+        keep(_mm256_sub_ps(shapeBottom, _mm256_loadu_ps(&batch.m_top[i])), deltaY, 2);
+        keep(_mm256_sub_ps(_mm256_loadu_ps(&batch.m_bottom[i]), shapeTop), _mm256_xor_ps(deltaY, sign), 3);
+
+        // Most colliders are far from the shape, the edges only matter once a swept bounding box overlaps
+        if (_mm256_movemask_ps(missed()) != 0xff)
+        {
+            for (size_t e = 0; e < batch.m_edges.size(); ++e)
+            {
+                const ColliderBatch::Edges &edges = batch.m_edges[e];
+                const __m256 a = _mm256_loadu_ps(&edges.a[i]);
+                const __m256 b = _mm256_loadu_ps(&edges.b[i]);
+                const __m256 c = _mm256_loadu_ps(&edges.c[i]);
+                const __m256 aPositive = _mm256_cmp_ps(a, zero, _CMP_GT_OQ);
+                const __m256 bPositive = _mm256_cmp_ps(b, zero, _CMP_GT_OQ);
+
+                const __m256 high = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_mul_ps(a, _mm256_blendv_ps(shapeLeft, shapeRight, aPositive)),
+                                      _mm256_mul_ps(b, _mm256_blendv_ps(shapeTop, shapeBottom, bPositive))),
+                        c);
+                const __m256 low = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_mul_ps(a, _mm256_blendv_ps(shapeRight, shapeLeft, aPositive)),
+                                      _mm256_mul_ps(b, _mm256_blendv_ps(shapeBottom, shapeTop, bPositive))),
+                        c);
+                const __m256 rate = _mm256_add_ps(_mm256_mul_ps(a, deltaX), _mm256_mul_ps(b, deltaY));
+
+                const auto side = static_cast<float>(ColliderBatch::BOUNDS_AXES + e * 2);
+                keep(high, rate, side);
+                keep(_mm256_sub_ps(_mm256_loadu_ps(&edges.apex[i]), low), _mm256_xor_ps(rate, sign), side + 1);
+            }
+        }
+
+        _mm256_storeu_ps(&times[i], _mm256_blendv_ps(enter, miss, missed()));
+        alignas(32) std::array<float, lanes> laneAxes{};
+        _mm256_store_ps(laneAxes.data(), axis);
+        for (size_t l = 0; l < lanes; ++l)
+            axes[i + l] = static_cast<uint8_t>(laneAxes[l]);
+    }
+
+    // Whatever doesn't fill a vector
+    batch.sweepScalar(shape, delta, i, times, axes);
+}
+
+#elif defined(GD_COLLIDE_SSE2)
+
+const char *getSweepBatchPath() { return "SSE2"; }
+
+// SSE2 has no blend, pick with masks instead
+static __m128 select(const __m128 condition, const __m128 whenTrue, const __m128 whenFalse)
+{
+    return _mm_or_ps(_mm_and_ps(condition, whenTrue), _mm_andnot_ps(condition, whenFalse));
+}
+
+void sweepBatch(const ColliderBatch &batch, const sf::FloatRect &shape, const sf::Vector2f &delta,
+                const std::span<float> times, const std::span<uint8_t> axes)
+{
+    SL_ASSERT(times.size() >= batch.size() and axes.size() >= batch.size(),
+              "Sweep results are too small for the batch");
+
+    const __m128 shapeLeft = _mm_set1_ps(shape.left);
+    const __m128 shapeTop = _mm_set1_ps(shape.top);
+    const __m128 shapeRight = _mm_set1_ps(shape.left + shape.width);
+    const __m128 shapeBottom = _mm_set1_ps(shape.top + shape.height);
+    const __m128 deltaX = _mm_set1_ps(delta.x);
+    const __m128 deltaY = _mm_set1_ps(delta.y);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 miss = _mm_set1_ps(INFINITY);
+
+    constexpr size_t lanes = 4;
+    size_t i = 0;
+    for (; i + lanes <= batch.size(); i += lanes)
+    {
+        __m128 enter = zero;
+        __m128 exit = _mm_set1_ps(1);
+        __m128 axis = _mm_set1_ps(ColliderBatch::NO_AXIS);
+        __m128 closed = zero;
+        // SweepWindow::keep for every lane, a rate of 0 can only close the window
+        const auto keep = [&](const __m128 value, const __m128 rate, const float side)
+        {
+            const __m128 t = _mm_div_ps(_mm_xor_ps(value, sign), rate);
+            const __m128 entering = _mm_and_ps(_mm_cmpgt_ps(rate, zero), _mm_cmpgt_ps(t, enter));
+            enter = select(entering, t, enter);
+            axis = select(entering, _mm_set1_ps(side), axis);
+            exit = select(_mm_cmplt_ps(rate, zero), _mm_min_ps(t, exit), exit);
+            closed = _mm_or_ps(closed, _mm_and_ps(_mm_cmpeq_ps(rate, zero), _mm_cmple_ps(value, zero)));
+        };
+        const auto missed = [&] { return _mm_or_ps(closed, _mm_cmpge_ps(enter, exit)); };
+
+        keep(_mm_sub_ps(shapeRight, _mm_loadu_ps(&batch.m_left[i])), deltaX, 0);
+        keep(_mm_sub_ps(_mm_loadu_ps(&batch.m_right[i]), shapeLeft), _mm_xor_ps(deltaX, sign), 1);
+        keep(_mm_sub_ps(shapeBottom, _mm_loadu_ps(&batch.m_top[i])), deltaY, 2);
+        keep(_mm_sub_ps(_mm_loadu_ps(&batch.m_bottom[i]), shapeTop), _mm_xor_ps(deltaY, sign), 3);
+
+        // Most colliders are far from the shape, the edges only matter once a swept bounding box overlaps
+        if (_mm_movemask_ps(missed()) != 0xf)
+        {
+            for (size_t e = 0; e < batch.m_edges.size(); ++e)
+            {
+                const ColliderBatch::Edges &edges = batch.m_edges[e];
+                const __m128 a = _mm_loadu_ps(&edges.a[i]);
+                const __m128 b = _mm_loadu_ps(&edges.b[i]);
+                const __m128 c = _mm_loadu_ps(&edges.c[i]);
+                const __m128 aPositive = _mm_cmpgt_ps(a, zero);
+                const __m128 bPositive = _mm_cmpgt_ps(b, zero);
+
+                const __m128 high = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, select(aPositive, shapeRight, shapeLeft)),
+                                                          _mm_mul_ps(b, select(bPositive, shapeBottom, shapeTop))),
+                                               c);
+                const __m128 low = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, select(aPositive, shapeLeft, shapeRight)),
+                                                         _mm_mul_ps(b, select(bPositive, shapeTop, shapeBottom))),
+                                              c);
+                const __m128 rate = _mm_add_ps(_mm_mul_ps(a, deltaX), _mm_mul_ps(b, deltaY));
+
+                const auto side = static_cast<float>(ColliderBatch::BOUNDS_AXES + e * 2);
+                keep(high, rate, side);
+                keep(_mm_sub_ps(_mm_loadu_ps(&edges.apex[i]), low), _mm_xor_ps(rate, sign), side + 1);
+            }
+        }
+
+        _mm_storeu_ps(&times[i], select(missed(), miss, enter));
+        alignas(16) std::array<float, lanes> laneAxes{};
+        _mm_store_ps(laneAxes.data(), axis);
+        for (size_t l = 0; l < lanes; ++l)
+            axes[i + l] = static_cast<uint8_t>(laneAxes[l]);
+    }
+
+    // Whatever doesn't fill a vector
+    batch.sweepScalar(shape, delta, i, times, axes);
+}
+
+#else
+
+const char *getSweepBatchPath() { return "scalar"; }
+
+void sweepBatch(const ColliderBatch &batch, const sf::FloatRect &shape, const sf::Vector2f &delta,
+                const std::span<float> times, const std::span<uint8_t> axes)
+{
+    sweepBatchScalar(batch, shape, delta, times, axes);
+}
+
+#endif
@@ -3,72 +3,111 @@
 
 #include "simplelogger.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 
+namespace
+{
+/* The times in [0, 1] a moving shape overlaps a collider, narrowed one axis at a time like the separating axis
+ * test but with the distances changing over the move */
+class SweepWindow
+{
+public:
+    /* Keeps the times where value + rate * t > 0, normal is the side crossed when it starts holding */
+    void keep(const float value, const float rate, const sf::Vector2f &normal)
+    {
+        if (rate == 0)
+        {
+            if (value <= 0)
+                m_open = false;
+            return;
+        }
+
+        const float t = -value / rate;
+        if (rate > 0)
+        {
+            if (t > m_enter)
+            {
+                m_enter = t;
+                m_normal = normal;
+            }
+        }
+        else
+        {
+            m_exit = std::min(m_exit, t);
+        }
+    }
+
+    // Shapes that only touch don't collide, so the window has to be longer than an instant
+    [[nodiscard]] std::optional<SweepHit> getHit() const
+    {
+        if (!m_open or m_enter >= m_exit)
+            return std::nullopt;
+        return SweepHit{m_enter, m_normal};
+    }
+
+    /* The axes of a bounding box, shared by both colliders */
+    void keepBounds(const sf::FloatRect &bounds, const sf::FloatRect &shape, const sf::Vector2f &delta)
+    {
+        keep(shape.left + shape.width - bounds.left, delta.x, {-1, 0});
+        keep(bounds.left + bounds.width - shape.left, -delta.x, {1, 0});
+        keep(shape.top + shape.height - bounds.top, delta.y, {0, -1});
+        keep(bounds.top + bounds.height - shape.top, -delta.y, {0, 1});
+    }
+
+private:
+    float m_enter = 0;
+    float m_exit = 1;
+    sf::Vector2f m_normal{0, 0};
+    bool m_open = true;
+};
+} // namespace
+
 RectangleCollider::RectangleCollider(const sf::Vector2f &topLeft, const sf::Vector2f &size)
 {
     m_shape.left = topLeft.x;
     m_shape.top = topLeft.y;
     m_shape.height = size.y;
     m_shape.width = size.x;
-}
 
-bool RectangleCollider::collides(const sf::FloatRect &shape)
-{
     SL_ASSERT(m_shape.width > 0, "Rectangle collider has zero width");
     SL_ASSERT(m_shape.height > 0, "Rectangle collider has zero height");
-    return m_shape.intersects(shape);
 }
 
 TriangleCollider::TriangleCollider(const sf::Vector2f &leftPoint, const sf::Vector2f &rightPoint,
                                    const sf::Vector2f &topPoint) :
     m_leftPoint(leftPoint), m_rightPoint(rightPoint), m_topPoint(topPoint)
 {
-    const sf::Vector2f leftToRight = rightPoint - leftPoint;
-    const sf::Vector2f leftToTop = topPoint - leftPoint;
-    m_leftMinAngle = std::atan2(leftToTop.y, leftToTop.x);
-    m_leftMaxAngle = std::atan2(leftToRight.y, leftToRight.x);
-
-    const sf::Vector2f rightToTop = topPoint - rightPoint;
-    const sf::Vector2f rightToLeft = -leftToRight;
-    m_rightMaxAngle = std::atan2(rightToTop.y, rightToTop.x);
-    m_rightMinAngle = std::atan2(rightToLeft.y, rightToLeft.x);
+    buildEdges();
 }
 
-bool TriangleCollider::collides(const sf::FloatRect &shape)
+void TriangleCollider::buildEdges()
 {
-    if (std::ranges::any_of(std::array<sf::Vector2f, 4>({
-                                    sf::Vector2f(shape.left, shape.top),
-                                    sf::Vector2f(shape.left + shape.width, shape.top),
-                                    sf::Vector2f(shape.left, shape.top + shape.height),
-                                    sf::Vector2f(shape.left + shape.width, shape.top + shape.height),
-                            }),
-                            [this](const sf::Vector2f &point) { return inside(point); }))
-        return true;
-    if (std::ranges::any_of(std::array<sf::Vector2f, 3>({m_leftPoint, m_rightPoint, m_topPoint}),
-                            [shape](const sf::Vector2f &point) { return shape.contains(point); }))
-        return true;
-
-    return false;
-}
-
+    const std::array<sf::Vector2f, 3> points{m_leftPoint, m_rightPoint, m_topPoint};
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const sf::Vector2f &from = points[i];
+        const sf::Vector2f &to = points[(i + 1) % 3];
+        const sf::Vector2f &opposite = points[(i + 2) % 3];
 
-bool TriangleCollider::inside(const sf::Vector2f &point) const
-{
-    // Angle of slope
-    sf::Vector2f angle = point - m_leftPoint;
+        Edge edge{from.y - to.y, to.x - from.x, 0, 0};
+        edge.c = -(edge.a * from.x + edge.b * from.y);
+        edge.apex = edge.a * opposite.x + edge.b * opposite.y + edge.c;
+        // Face the normal into the triangle whichever way round the points are
+        if (edge.apex < 0)
+            edge = Edge{-edge.a, -edge.b, -edge.c, -edge.apex};
 
-    SL_ASSERT_FALSE(angle.y == 0 and angle.x == 0, "Triangle collider has zero slope");
-    if (float angleSlope = std::atan2(angle.y, angle.x); angleSlope > m_leftMinAngle and angleSlope < m_leftMaxAngle)
-    {
-        // Only need to check 2 points otherwise it can't be in the third point
-        angle = point - m_rightPoint;
-        if (angleSlope = std::atan2(angle.y, angle.x); angleSlope > m_rightMinAngle and angleSlope < m_rightMaxAngle)
-            return true;
+        m_edges[i] = edge;
     }
 
-    return false;
+    const float left = std::min({m_leftPoint.x, m_rightPoint.x, m_topPoint.x});
+    const float top = std::min({m_leftPoint.y, m_rightPoint.y, m_topPoint.y});
+    const float right = std::max({m_leftPoint.x, m_rightPoint.x, m_topPoint.x});
+    const float bottom = std::max({m_leftPoint.y, m_rightPoint.y, m_topPoint.y});
+    m_bounds = sf::FloatRect(left, top, right - left, bottom - top);
+
+    SL_ASSERT(m_edges[0].apex > 0, "Triangle collider has zero area");
 }
 
 void TriangleCollider::setPosition(const sf::Vector2f &position)
@@ -78,4 +117,37 @@ void TriangleCollider::setPosition(const sf::Vector2f &position)
     m_rightPoint = m_rightPoint + offset;
     m_topPoint = sf::Vector2f(m_topPoint.x + offset.x, position.y);
     m_leftPoint = sf::Vector2f(position.x, m_leftPoint.y + offset.y);
+    buildEdges();
+}
+
+std::optional<SweepHit> RectangleCollider::sweep(const sf::FloatRect &shape, const sf::Vector2f &delta) const
+{
+    SweepWindow window;
+    window.keepBounds(m_shape, shape, delta);
+    return window.getHit();
+}
+
+std::optional<SweepHit> TriangleCollider::sweep(const sf::FloatRect &shape, const sf::Vector2f &delta) const
+{
+    SweepWindow window;
+    window.keepBounds(m_bounds, shape, delta);
+
+    const float left = shape.left;
+    const float top = shape.top;
+    const float right = shape.left + shape.width;
+    const float bottom = shape.top + shape.height;
+    for (const Edge &edge: m_edges)
+    {
+        const float high = edge.a * (edge.a > 0 ? right : left) + edge.b * (edge.b > 0 ? bottom : top) + edge.c;
+        const float low = edge.a * (edge.a > 0 ? left : right) + edge.b * (edge.b > 0 ? top : bottom) + edge.c;
+        // Moving the shape moves its whole extent along the edge normal by the same amount
+        const float rate = edge.a * delta.x + edge.b * delta.y;
+        const float length = std::hypot(edge.a, edge.b);
+        const sf::Vector2f normal(edge.a / length, edge.b / length);
+
+        window.keep(high, rate, -normal);
+        window.keep(edge.apex - low, -rate, normal);
+    }
+
+    return window.getHit();
 }
@@ -0,0 +1,350 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "game/LayerParser.h"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <memory>
+
+#include "simplelogger.hpp"
+#include "zlib.h"
+#include "zstd.h"
+
+namespace
+{
+inline bool isSpace(const char c) { return c == '\n' or c == '\r' or c == ' ' or c == '\t'; }
+
+inline const char *skipSpace(const char *it, const char *end)
+{
+    while (it != end and isSpace(*it))
+        ++it;
+    return it;
+}
+
+constexpr int8_t BASE64_INVALID = -1;
+constexpr int8_t BASE64_SPACE = -2;
+
+constexpr std::array<int8_t, 256> BASE64_TABLE = []
+{
+    std::array<int8_t, 256> table{};
+    table.fill(BASE64_INVALID);
+
+    constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (size_t i = 0; i < alphabet.size(); ++i)
+    {
+        table[static_cast<uint8_t>(alphabet[i])] = static_cast<int8_t>(i);
+    }
+    for (const char c: {'\n', '\r', ' ', '\t'})
+    {
+        table[static_cast<uint8_t>(c)] = BASE64_SPACE;
+    }
+
+    return table;
+}();
+
+/* Decodes base64 a block at a time so the decompressors never need the whole layer in memory */
+class Base64Reader
+{
+public:
+    explicit Base64Reader(const std::string_view data) : m_data(data) {}
+
+    /* Returns the number of bytes written, 0 once the data runs out */
+    size_t read(const std::span<std::byte> out)
+    {
+        size_t written = 0;
+        while (written < out.size() and m_pos < m_data.size())
+        {
+            // Whole groups of four characters decode straight to three bytes
+            while (m_bitCount == 0 and written + 3 <= out.size() and m_pos + 4 <= m_data.size())
+            {
+                const int8_t a = BASE64_TABLE[static_cast<uint8_t>(m_data[m_pos])];
+                const int8_t b = BASE64_TABLE[static_cast<uint8_t>(m_data[m_pos + 1])];
+                const int8_t c = BASE64_TABLE[static_cast<uint8_t>(m_data[m_pos + 2])];
+                const int8_t d = BASE64_TABLE[static_cast<uint8_t>(m_data[m_pos + 3])];
+                if ((a | b | c | d) < 0 or m_ended)
+                    break;
+
+                const uint32_t bits = a << 18 | b << 12 | c << 6 | d;
+                out[written++] = static_cast<std::byte>(bits >> 16);
+                out[written++] = static_cast<std::byte>(bits >> 8 & 0xFF);
+                out[written++] = static_cast<std::byte>(bits & 0xFF);
+                m_pos += 4;
+            }
+            if (written == out.size() or m_pos == m_data.size())
+                break;
+
+            const char c = m_data[m_pos++];
+            if (c == '=')
+            {
+                m_ended = true;
+                continue;
+            }
+
+            const int8_t value = BASE64_TABLE[static_cast<uint8_t>(c)];
+            if (value == BASE64_SPACE)
+                continue;
+            if (value == BASE64_INVALID or m_ended)
+            {
+                SL_LOGF_FATAL("Failed to parse layer due to unexpected character '{}' at offset {}", c, m_pos - 1);
+                m_failed = true;
+                return written;
+            }
+
+            m_bits = m_bits << 6 | static_cast<uint32_t>(value);
+            m_bitCount += 6;
+            if (m_bitCount >= 8)
+            {
+                m_bitCount -= 8;
+                out[written++] = static_cast<std::byte>(m_bits >> m_bitCount & 0xFF);
+            }
+        }
+
+        return written;
+    }
+
+    [[nodiscard]] bool failed() const { return m_failed; }
+
+private:
+    std::string_view m_data;
+    size_t m_pos = 0;
+
+    uint32_t m_bits = 0;
+    int m_bitCount = 0;
+    bool m_ended = false;
+    bool m_failed = false;
+};
+
+constexpr size_t DECODE_BLOCK_SIZE = 16 * 1024;
+
+/* Decompressors write into the map until it is full, then into a scratch buffer to find out if anything is left */
+class LayerWriter
+{
+public:
+    explicit LayerWriter(const std::span<uint32_t> out) : m_out(std::as_writable_bytes(out)) {}
+
+    [[nodiscard]] std::span<std::byte> next()
+    {
+        if (m_written < m_out.size())
+            return m_out.subspan(m_written);
+        return m_overflow;
+    }
+
+    void advance(const size_t bytes)
+    {
+        if (m_written < m_out.size())
+            m_written += bytes;
+        else if (bytes != 0)
+            m_overflowed = true;
+    }
+
+    [[nodiscard]] bool finish(size_t &count) const
+    {
+        count = m_written / sizeof(uint32_t);
+        if (m_overflowed)
+        {
+            SL_LOGF_FATAL("Layer is too large, expected {} cells", m_out.size() / sizeof(uint32_t));
+            return false;
+        }
+        if (m_written % sizeof(uint32_t) != 0)
+        {
+            SL_LOG_FATAL("Failed to parse layer, the data ends partway through a cell");
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    std::span<std::byte> m_out;
+    size_t m_written = 0;
+
+    std::array<std::byte, 64> m_overflow{};
+    bool m_overflowed = false;
+};
+
+bool inflateLayer(Base64Reader &reader, LayerWriter &writer)
+{
+    z_stream stream{};
+    // Adding 32 detects both zlib and gzip headers
+    if (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK)
+    {
+        SL_LOG_FATAL("Failed to initialize zlib");
+        return false;
+    }
+
+    std::array<std::byte, DECODE_BLOCK_SIZE> input{};
+    bool inputLeft = true;
+    int result = Z_OK;
+    while (result != Z_STREAM_END)
+    {
+        if (stream.avail_in == 0 and inputLeft)
+        {
+            const size_t read = reader.read(input);
+            inputLeft = read != 0 and !reader.failed();
+            stream.next_in = reinterpret_cast<Bytef *>(input.data());
+            stream.avail_in = static_cast<uInt>(read);
+        }
+        if (reader.failed())
+            break;
+
+        const std::span<std::byte> output = writer.next();
+        stream.next_out = reinterpret_cast<Bytef *>(output.data());
+        stream.avail_out = static_cast<uInt>(output.size());
+
+        result = inflate(&stream, Z_NO_FLUSH);
+        writer.advance(output.size() - stream.avail_out);
+
+        if (result == Z_BUF_ERROR and stream.avail_in == 0 and !inputLeft)
+        {
+            SL_LOG_FATAL("Failed to parse layer, the compressed data is truncated");
+            break;
+        }
+        if (result != Z_OK and result != Z_STREAM_END and result != Z_BUF_ERROR)
+        {
+            SL_LOGF_FATAL("Failed to inflate layer: {}", stream.msg ? stream.msg : "unknown error");
+            break;
+        }
+    }
+
+    inflateEnd(&stream);
+    return result == Z_STREAM_END and !reader.failed();
+}
+
+bool decompressZstdLayer(Base64Reader &reader, LayerWriter &writer)
+{
+    const std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+    if (!context)
+    {
+        SL_LOG_FATAL("Failed to initialize zstd");
+        return false;
+    }
+
+    std::array<std::byte, DECODE_BLOCK_SIZE> input{};
+    ZSTD_inBuffer in{input.data(), 0, 0};
+    size_t result = 0;
+    bool flushing = false;
+    while (true)
+    {
+        if (in.pos == in.size and !flushing)
+        {
+            in.size = reader.read(input);
+            in.pos = 0;
+            if (reader.failed())
+                return false;
+            if (in.size == 0)
+                break;
+        }
+
+        const std::span<std::byte> output = writer.next();
+        ZSTD_outBuffer out{output.data(), output.size(), 0};
+        result = ZSTD_decompressStream(context.get(), &out, &in);
+        writer.advance(out.pos);
+
+        if (ZSTD_isError(result))
+        {
+            SL_LOGF_FATAL("Failed to decompress layer: {}", ZSTD_getErrorName(result));
+            return false;
+        }
+
+        // The decoder may be holding output back when the buffer filled up
+        flushing = out.pos == out.size;
+    }
+
+    // Anything but 0 means the last frame was cut off
+    if (result != 0)
+    {
+        SL_LOG_FATAL("Failed to parse layer, the compressed data is truncated");
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+bool parseCsvLayer(const std::string_view csv, const std::span<uint32_t> out, size_t &count)
+{
+    count = 0;
+
+    const char *begin = csv.data();
+    const char *end = begin + csv.size();
+    const char *it = skipSpace(begin, end);
+    while (it != end)
+    {
+        if (count >= out.size())
+        {
+            SL_LOGF_FATAL("Layer is too large, expected {} cells", out.size());
+            return false;
+        }
+
+        const auto [next, error] = std::from_chars(it, end, out[count]);
+        if (error == std::errc::result_out_of_range)
+        {
+            SL_LOGF_FATAL("Failed to parse layer due to out of range number at offset {}", it - begin);
+            return false;
+        }
+        if (error != std::errc{})
+        {
+            SL_LOGF_FATAL("Failed to parse layer due to unexpected character '{}' at offset {}", *it, it - begin);
+            return false;
+        }
+        ++count;
+
+        // Tiled puts a comma at the end of every row but the last
+        it = skipSpace(next, end);
+        if (it == end)
+            break;
+        if (*it != ',')
+        {
+            SL_LOGF_FATAL("Failed to parse layer due to unexpected character '{}' at offset {}", *it, it - begin);
+            return false;
+        }
+        it = skipSpace(it + 1, end);
+    }
+
+    return true;
+}
+
+bool parseBase64Layer(const std::string_view base64, const LayerCompression compression,
+                      const std::span<uint32_t> out, size_t &count)
+{
+    count = 0;
+
+    Base64Reader reader(base64);
+    LayerWriter writer(out);
+    switch (compression)
+    {
+        case LayerCompression::None:
+            while (true)
+            {
+                const size_t read = reader.read(writer.next());
+                writer.advance(read);
+                if (read == 0 or reader.failed())
+                    break;
+            }
+            if (reader.failed())
+                return false;
+            break;
+        case LayerCompression::Zlib:
+        case LayerCompression::Gzip:
+            if (!inflateLayer(reader, writer))
+                return false;
+            break;
+        case LayerCompression::Zstd:
+            if (!decompressZstdLayer(reader, writer))
+                return false;
+            break;
+    }
+
+    if (!writer.finish(count))
+        return false;
+
+    if constexpr (std::endian::native == std::endian::big)
+    {
+        for (uint32_t &cell: out.first(count))
+        {
+            cell = (cell >> 24) | (cell >> 8 & 0xFF00) | (cell << 8 & 0xFF0000) | (cell << 24);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,572 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "game/Level.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+
+#include "AssetManager.h"
+#include "GeometryDash.h"
+#include "simplelogger.hpp"
+
+// From https://doc.mapeditor.org/en/latest/reference/global-tile-ids/#gid-tile-flipping
+constexpr uint32_t FLIPPED_HORIZONTALLY_FLAG = 0x80000000;
+constexpr uint32_t FLIPPED_VERTICALLY_FLAG = 0x40000000;
+constexpr uint32_t FLIPPED_DIAGONALLY_FLAG = 0x20000000;
+constexpr uint32_t ROTATED_HEXAGONAL_120_FLAG = 0x10000000;
+
+#ifndef OS_SEP
+
+#ifdef WIN32
+#define OS_SEP "\\"
+#else
+#define OS_SEP "/"
+#endif
+
+#endif // OS_SEP
+
+std::string getFileFolder(const std::string &filePath)
+{
+    std::string path = filePath;
+    if (const size_t lastSlash = path.find_last_of("\\/"); lastSlash != std::string::npos)
+    {
+        path = path.substr(0, lastSlash);
+    }
+
+    return path;
+}
+
+std::string getTileImageId(const int gid) { return std::format("tile-{}", gid); }
+
+bool Level::loadFromFile(const std::string &filePath, const std::vector<std::string> &sharedTextures,
+                         const bool loadGraphics)
+{
+    auto data = std::make_shared<LevelData>();
+    if (!data->loadFromFile(filePath))
+        return false;
+
+    m_data = data;
+    m_filePath = filePath;
+    m_size = data->getSize();
+    m_tileSize = data->getTileSize();
+    m_map = data->getMap();
+    const std::vector<TileSet> &tileSets = data->getTileSets();
+    m_hasGraphics = loadGraphics;
+
+    if (loadGraphics and !loadAtlas(filePath, tileSets, sharedTextures))
+        return false;
+
+    SL_LOG_DEBUG("Creating world");
+
+    createWorld(tileSets);
+
+    SL_LOG_DEBUG("Created level");
+
+    return true;
+}
+
+bool Level::loadAtlas(const std::string &filePath, const std::vector<TileSet> &tileSets,
+                      const std::vector<std::string> &sharedTextures)
+{
+    std::string folder = getFileFolder(filePath);
+    for (const auto &tileSet: tileSets)
+    {
+        int i = 0;
+        for (auto iter = tileSet.tiles.begin(); iter != tileSet.tiles.end(); ++i, ++iter)
+        {
+            sf::Image image;
+            if (!image.loadFromFile(folder + OS_SEP + iter->texture))
+            {
+                SL_LOG_FATAL(std::format("Failed to load texture {}", folder + OS_SEP + iter->texture));
+                return false;
+            }
+
+            m_atlas.add(getTileImageId(i + tileSet.firstGid), image);
+        }
+    }
+
+    for (const auto &id: sharedTextures)
+    {
+        const sf::Texture &texture = AssetManager::getInstance().getTexture(id);
+        m_atlas.add(id, texture.copyToImage(), texture.isSmooth());
+    }
+
+    if (!m_atlas.build())
+    {
+        SL_LOG_FATAL(std::format("Failed to build the texture atlas for {}", filePath));
+        return false;
+    }
+
+    return true;
+}
+
+void Level::createWorld(const std::vector<TileSet> &set)
+{
+    if (set.empty())
+    {
+        SL_LOG_FATAL("Failed to load any tile sets");
+        return;
+    }
+    if (m_size.x > UINT16_MAX or m_size.y > UINT16_MAX)
+    {
+        SL_LOGF_FATAL("Level size {}x{} is too big, tiles are stored with 16 bit coordinates", m_size.x, m_size.y);
+        return;
+    }
+
+    std::vector<TileSet> nset = set;
+    std::ranges::sort(nset, [](const TileSet &a, const TileSet &b) { return a.firstGid < b.firstGid; });
+    buildTileTable(nset);
+
+    size_t count = 0;
+    for (const auto &pos: m_map)
+    {
+        if (pos != 0)
+            count++;
+    }
+    m_tileColumns.reserve(count);
+    m_tileRows.reserve(count);
+    m_tileIds.reserve(count);
+    m_tileTypes.reserve(count);
+    m_tileFlips.reserve(count);
+
+    // Column by column, bottom to top, so the tiles come out sorted by x without sorting
+    for (int c = 0; c < m_size.x; ++c)
+    {
+        for (int r = m_size.y - 1; r > 0; --r)
+        {
+            uint32_t value = m_map[r * m_size.x + c];
+            if (value == 0)
+                continue;
+
+            uint8_t flips = 0;
+            if (value & FLIPPED_HORIZONTALLY_FLAG)
+                flips |= TILE_FLIPPED_HORIZONTALLY;
+            if (value & FLIPPED_VERTICALLY_FLAG)
+                flips |= TILE_FLIPPED_VERTICALLY;
+            if (value & FLIPPED_DIAGONALLY_FLAG)
+                flips |= TILE_FLIPPED_DIAGONALLY;
+
+            // Clear the flags
+            value &= ~(FLIPPED_HORIZONTALLY_FLAG | FLIPPED_VERTICALLY_FLAG | FLIPPED_DIAGONALLY_FLAG |
+                       ROTATED_HEXAGONAL_120_FLAG);
+
+            if (value >= m_tiles.size() or m_tiles[value].tileSet == NO_TILE_SET)
+            {
+                SL_LOGF_WARNING("No tile set contains gid {}", value);
+                continue;
+            }
+            if (value > UINT16_MAX)
+            {
+                SL_LOGF_WARNING("Gid {} doesn't fit in 16 bits, skipping it", value);
+                continue;
+            }
+            const TileInfo &tile = m_tiles[value];
+
+            const size_t index = m_tileIds.size();
+            m_tileColumns.push_back(static_cast<uint16_t>(c));
+            m_tileRows.push_back(static_cast<uint16_t>(r));
+            m_tileIds.push_back(static_cast<uint16_t>(value));
+            m_tileTypes.push_back(tile.type);
+            m_tileFlips.push_back(flips);
+
+            if (tile.frameRate <= 0)
+                continue;
+
+            // Animated tiles keep a full item for their animation state
+            const TileSet &tileSet = nset[tile.tileSet];
+            const int columns = std::max(1, tileSet.columnCount);
+            // Levels loaded without graphics have no atlas, the item only keeps its collider and animation
+            const std::string imageId = getTileImageId(tileSet.firstGid);
+            const bool hasImage = m_atlas.contains(imageId);
+            const AtlasRegion region = hasImage ? m_atlas.getRegion(imageId) : AtlasRegion{};
+            ArenaItem item(hasImage ? m_atlas.getPage(region.page) : nullptr, getTilePosition(index),
+                           sf::Vector2f(m_tileSize), sf::Vector2i(tileSet.columnCount, tileSet.tileCount / columns),
+                           sf::Vector2i(tileSet.padding, tileSet.padding), tile.frame);
+            item.setTextureOrigin(region.rect.getPosition());
+            item.setFlippedHorizontally(flips & TILE_FLIPPED_HORIZONTALLY);
+            item.setFlippedVertically(flips & TILE_FLIPPED_VERTICALLY);
+            item.setFlippedDiagonally(flips & TILE_FLIPPED_DIAGONALLY);
+            item.setAnimation(tile.minFrame, tile.maxFrame, tile.frameRate);
+            item.setType(tile.type);
+            m_objects.push_back(std::move(item));
+            m_objectTiles.push_back(index);
+        }
+    }
+
+    SL_LOGF_DEBUG("Loaded {} tiles in {} bytes, {} of them have an item", m_tileIds.size(),
+                  m_tileIds.size() * (sizeof(uint16_t) * 3 + sizeof(ArenaItemType) + sizeof(uint8_t)),
+                  m_objects.size());
+
+    buildGrid();
+    buildChunks();
+
+    findStartPosition();
+}
+
+void Level::buildTileTable(const std::vector<TileSet> &set)
+{
+    m_tiles.clear();
+    for (size_t index = 0; index < set.size(); ++index)
+    {
+        const TileSet &ts = set[index];
+
+        ArenaItemType type = ArenaItemType::Default;
+        if (ts.name == "Spikes")
+        {
+            type = ArenaItemType::Spike;
+        }
+        else if (ts.name == "TinySpikes")
+        {
+            type = ArenaItemType::TinySpike;
+        }
+        else if (ts.name != "Default" and ts.name != "SimpleTileSet")
+        {
+            SL_LOGF_WARNING("Unknown object type: {}, treating it as a default block", ts.name);
+        }
+
+        // Image collections have one image per tile, otherwise the frames are cut from a single image
+        const bool collection = ts.tiles.size() > 1;
+        const int count = collection ? static_cast<int>(ts.tiles.size()) : std::max(1, ts.tileCount);
+        if (ts.firstGid <= 0)
+        {
+            SL_LOGF_WARNING("Tile set {} has an invalid first gid {}", ts.name, ts.firstGid);
+            continue;
+        }
+        m_tiles.resize(std::max(m_tiles.size(), static_cast<size_t>(ts.firstGid + count)));
+
+        const std::string id = getTileImageId(ts.firstGid);
+        const AtlasRegion region = m_atlas.contains(id) ? m_atlas.getRegion(id) : AtlasRegion{};
+        const int columns = std::max(1, ts.columnCount);
+        for (int frame = 0; frame < count; ++frame)
+        {
+            TileInfo &tile = m_tiles[ts.firstGid + frame];
+            tile.tileSet = static_cast<int>(index);
+            tile.type = type;
+            tile.frame = frame;
+
+            if (collection)
+            {
+                const std::string frameId = getTileImageId(ts.firstGid + frame);
+                if (m_atlas.contains(frameId))
+                    tile.region = m_atlas.getRegion(frameId);
+                continue;
+            }
+
+            const sf::Vector2i cell(frame % columns, frame / columns);
+            tile.region = AtlasRegion{region.page, sf::IntRect(region.rect.left + cell.x * (ts.tileWidth + ts.padding),
+                                                               region.rect.top + cell.y * (ts.tileHeight + ts.padding),
+                                                               ts.tileWidth, ts.tileHeight)};
+        }
+    }
+}
+
+const AtlasRegion &Level::getTileRegion(const uint32_t gid) const
+{
+    static const AtlasRegion empty{};
+    if (gid >= m_tiles.size())
+        return empty;
+
+    return m_tiles[gid].region;
+}
+
+void Level::findStartPosition()
+{
+    m_startPosition.x = 0;
+    SL_LOG_DEBUG("Finding starting Y position");
+    for (int i = 0; i < m_size.x * m_size.y; i += m_size.x)
+    {
+        if (m_map[i] != 0)
+        {
+            SL_LOG_DEBUG(std::format("Found first item at y position {}", i / m_size.x));
+            m_startPosition.y = static_cast<float>(
+                    static_cast<double>(i) / static_cast<double>(m_size.x) * m_tileSize.x - m_tileSize.x * 10);
+            SL_LOG_DEBUG(std::format("Starting at y location {}", m_startPosition.y));
+            break;
+        }
+    }
+}
+
+void Level::buildGrid()
+{
+    m_grid.assign(static_cast<size_t>(m_size.x) * m_size.y, EMPTY_CELL);
+    m_rowWords = (static_cast<size_t>(m_size.x) + 63) / 64;
+    std::vector<uint64_t> solid(m_rowWords * m_size.y, 0);
+    m_shapeCells.assign(m_rowWords * m_size.y, 0);
+
+    for (size_t i = 0; i < m_tileIds.size(); ++i)
+    {
+        const size_t c = m_tileColumns[i];
+        const size_t r = m_tileRows[i];
+        m_grid[r * m_size.x + c] = static_cast<int32_t>(i);
+
+        // Anything that isn't a plain block has a shape that doesn't fill its cell
+        std::vector<uint64_t> &bits = m_tileTypes[i] == ArenaItemType::Default ? solid : m_shapeCells;
+        bits[r * m_rowWords + c / 64] |= uint64_t{1} << (c % 64);
+    }
+
+    buildSolidRects(std::move(solid));
+}
+
+void Level::buildSolidRects(std::vector<uint64_t> solid)
+{
+    const auto isSolid = [&](const int c, const int r)
+    { return (solid[r * m_rowWords + c / 64] >> (c % 64) & 1) != 0; };
+    const auto clear = [&](const int c, const int r) { solid[r * m_rowWords + c / 64] &= ~(uint64_t{1} << (c % 64)); };
+
+    // Greedy, grow each rectangle right as far as the row goes and then down while the rows below are as long. Cells
+    // are cleared as they are taken so every block ends up in exactly one rectangle
+    m_solidRects.clear();
+    size_t blocks = 0;
+    for (int r = 0; r < m_size.y; ++r)
+    {
+        for (int c = 0; c < m_size.x; ++c)
+        {
+            if (!isSolid(c, r))
+                continue;
+
+            int width = 1;
+            while (c + width < m_size.x and isSolid(c + width, r))
+                ++width;
+
+            int height = 1;
+            while (r + height < m_size.y)
+            {
+                bool full = true;
+                for (int x = c; x < c + width and full; ++x)
+                    full = isSolid(x, r + height);
+                if (!full)
+                    break;
+                ++height;
+            }
+
+            for (int y = r; y < r + height; ++y)
+            {
+                for (int x = c; x < c + width; ++x)
+                    clear(x, y);
+            }
+            m_solidRects.emplace_back(c, r, width, height);
+            blocks += static_cast<size_t>(width) * height;
+        }
+    }
+
+    // Bucket the rectangles by column so a query only looks at the ones nearby
+    const size_t buckets = (m_size.x + SOLID_BUCKET_COLUMNS - 1) / SOLID_BUCKET_COLUMNS;
+    m_solidBuckets.assign(buckets + 1, 0);
+    for (const auto &rect: m_solidRects)
+    {
+        for (int b = rect.left / SOLID_BUCKET_COLUMNS; b <= (rect.left + rect.width - 1) / SOLID_BUCKET_COLUMNS; ++b)
+            ++m_solidBuckets[b + 1];
+    }
+    for (size_t b = 0; b < buckets; ++b)
+        m_solidBuckets[b + 1] += m_solidBuckets[b];
+
+    m_solidBucketRects.resize(m_solidBuckets.back());
+    std::vector<uint32_t> next(m_solidBuckets.begin(), m_solidBuckets.end() - 1);
+    for (size_t i = 0; i < m_solidRects.size(); ++i)
+    {
+        const sf::IntRect &rect = m_solidRects[i];
+        for (int b = rect.left / SOLID_BUCKET_COLUMNS; b <= (rect.left + rect.width - 1) / SOLID_BUCKET_COLUMNS; ++b)
+            m_solidBucketRects[next[b]++] = static_cast<uint32_t>(i);
+    }
+
+    SL_LOGF_DEBUG("Merged {} solid blocks into {} collision rectangles", blocks, m_solidRects.size());
+}
+
+std::optional<TileSweep> Level::sweepSolid(const sf::IntRect &cells, const sf::FloatRect &shape,
+                                           const sf::Vector2f &delta) const
+{
+    std::optional<TileSweep> first;
+    forEachSolidRect(cells,
+                     [&](const sf::IntRect &rect, const sf::IntRect &)
+                     {
+                         const RectangleCollider collider(
+                                 sf::Vector2f(static_cast<float>(rect.left * m_tileSize.x),
+                                              static_cast<float>(rect.top * m_tileSize.y)),
+                                 sf::Vector2f(static_cast<float>(rect.width * m_tileSize.x),
+                                              static_cast<float>(rect.height * m_tileSize.y)));
+                         const std::optional<SweepHit> hit = collider.sweep(shape, delta);
+                         if (!hit)
+                             return;
+
+                         // The blocks of the rectangle the shape touches once it gets there
+                         constexpr float TOUCH = 0.01f;
+                         const sf::FloatRect moved{shape.left + delta.x * hit->time - TOUCH,
+                                                   shape.top + delta.y * hit->time - TOUCH, shape.width + TOUCH * 2,
+                                                   shape.height + TOUCH * 2};
+                         sf::IntRect touched;
+                         if (!getCellRange(moved, {0, 0}).intersects(rect, touched))
+                             return;
+                         const size_t tile = static_cast<size_t>(
+                                 m_grid[(touched.top + touched.height - 1) * m_size.x + touched.left]);
+
+                         if (!first or hit->time < first->sweep.time or
+                             (hit->time == first->sweep.time and isVisitedBefore(tile, first->hit.tile)))
+                             first = TileSweep{getTileHit(tile), *hit};
+                     });
+
+    return first;
+}
+
+size_t Level::findFirstTile(const float x) const
+{
+    const auto found = std::ranges::lower_bound(m_tileColumns, x, {}, [this](const uint16_t column)
+                                                { return static_cast<float>(column * m_tileSize.x); });
+    return found - m_tileColumns.begin();
+}
+
+size_t Level::findLastTile(const float x) const
+{
+    const auto found = std::ranges::upper_bound(m_tileColumns, x, {}, [this](const uint16_t column)
+                                                { return static_cast<float>(column * m_tileSize.x); });
+    return found - m_tileColumns.begin();
+}
+
+const ArenaItem *Level::findObject(const size_t tile) const
+{
+    if (m_objectTiles.empty())
+        return nullptr;
+
+    const auto found = std::ranges::lower_bound(m_objectTiles, tile);
+    if (found == m_objectTiles.end() or *found != tile)
+        return nullptr;
+
+    return &m_objects[found - m_objectTiles.begin()];
+}
+
+Collider Level::getCollider(const size_t tile) const
+{
+    if (const ArenaItem *object = findObject(tile); object != nullptr)
+        return object->getCollider();
+
+    return makeTileCollider(m_tileTypes[tile], m_tiles[m_tileIds[tile]].frame, getTilePosition(tile),
+                            sf::Vector2f(m_tileSize));
+}
+
+void Level::addCollider(const size_t tile, ColliderBatch &batch) const
+{
+    if (const ArenaItem *object = findObject(tile); object != nullptr)
+    {
+        batch.add(object->getCollider());
+        return;
+    }
+
+    const int frame = m_tiles[m_tileIds[tile]].frame;
+    const sf::Vector2f position = getTilePosition(tile);
+    const sf::Vector2f size(m_tileSize);
+    switch (m_tileTypes[tile])
+    {
+        case ArenaItemType::Spike:
+            batch.add(TileCollider<ArenaItemType::Spike>::make(frame, position, size));
+            break;
+        case ArenaItemType::TinySpike:
+            batch.add(TileCollider<ArenaItemType::TinySpike>::make(frame, position, size));
+            break;
+        case ArenaItemType::Default:
+        default:
+            batch.add(TileCollider<ArenaItemType::Default>::make(frame, position, size));
+            break;
+    }
+}
+
+void Level::notifyCollision(const size_t tile) const
+{
+    if (const ArenaItem *object = findObject(tile); object != nullptr and object->getOnCollision() != nullptr)
+        object->getOnCollision()();
+}
+
+void Level::renderCollider(const size_t tile, const sf::Vector2f &cameraPos, const sf::Vector2f &relativePosition,
+                           const bool collided) const
+{
+    renderTileCollider(m_tileTypes[tile], m_tiles[m_tileIds[tile]].frame,
+                       getTilePosition(tile) - relativePosition + cameraPos, sf::Vector2f(m_tileSize), collided);
+}
+
+sf::IntRect Level::getCellRange(const sf::FloatRect &shape, const sf::Vector2f &offset) const
+{
+    // The shape is relative to the offset, the grid is in world space
+    const float left = (shape.left + offset.x) / static_cast<float>(m_tileSize.x);
+    const float top = (shape.top + offset.y) / static_cast<float>(m_tileSize.y);
+    const float right = (shape.left + shape.width + offset.x) / static_cast<float>(m_tileSize.x);
+    const float bottom = (shape.top + shape.height + offset.y) / static_cast<float>(m_tileSize.y);
+
+    // Cells only touching the edge of the shape can't intersect it
+    const int c0 = std::max(0, static_cast<int>(std::floor(left)));
+    const int r0 = std::max(0, static_cast<int>(std::floor(top)));
+    const int c1 = std::min(m_size.x - 1, static_cast<int>(std::ceil(right)) - 1);
+    const int r1 = std::min(m_size.y - 1, static_cast<int>(std::ceil(bottom)) - 1);
+
+    return {c0, r0, c1 - c0 + 1, r1 - r0 + 1};
+}
+
+sf::VertexArray &getTextureBatch(std::vector<TextureBatch> &batches, const sf::Texture *texture)
+{
+    for (auto &batch: batches)
+    {
+        if (batch.texture == texture)
+            return batch.vertices;
+    }
+
+    batches.push_back(TextureBatch{texture});
+    return batches.back().vertices;
+}
+
+void Level::buildChunks()
+{
+    const int chunkWidth = m_tileSize.x * CHUNK_COLUMNS;
+
+    m_chunks.clear();
+    m_chunks.resize((m_size.x + CHUNK_COLUMNS - 1) / CHUNK_COLUMNS);
+    m_animatedObjects.clear();
+
+    size_t object = 0;
+    for (size_t i = 0; i < m_tileIds.size(); ++i)
+    {
+        // Both are in tile order, so the next object is the only one that can belong to this tile
+        if (object < m_objects.size() and m_objectTiles[object] == i)
+        {
+            if (m_objects[object].isAnimated())
+            {
+                m_animatedObjects.push_back(object++);
+                continue;
+            }
+            ++object;
+        }
+        if (!m_hasGraphics)
+            continue;
+
+        const AtlasRegion &region = m_tiles[m_tileIds[i]].region;
+        const sf::Vector2f position = getTilePosition(i);
+        const size_t chunk = std::clamp(static_cast<int>(position.x) / chunkWidth, 0,
+                                        static_cast<int>(m_chunks.size()) - 1);
+        batchTile(getTextureBatch(m_chunks[chunk].batches, m_atlas.getPage(region.page).get()), position,
+                  sf::Vector2f(m_tileSize), region.rect, m_tileFlips[i], sf::Color::White);
+        ++m_chunks[chunk].tiles;
+    }
+
+    SL_LOGF_DEBUG("Baked {} chunks, {} animated objects", m_chunks.size(), m_animatedObjects.size());
+}
+
+size_t Level::renderStatic(const float left, const float right, const sf::RenderStates &states) const
+{
+    sf::RenderWindow &window = GeometryDash::getInstance().getWindow().getWindow();
+    sf::RenderStates chunkStates = states;
+
+    size_t rendered = 0;
+    const float chunkWidth = static_cast<float>(std::max(1, m_tileSize.x * CHUNK_COLUMNS));
+    const int firstChunk = std::max(0, static_cast<int>(std::floor(left / chunkWidth)));
+    const int lastChunk =
+            std::min(static_cast<int>(m_chunks.size()) - 1, static_cast<int>(std::floor(right / chunkWidth)));
+    for (int c = firstChunk; c <= lastChunk; ++c)
+    {
+        const Chunk &chunk = m_chunks[c];
+        for (const auto &batch: chunk.batches)
+        {
+            chunkStates.texture = batch.texture;
+            window.draw(batch.vertices, chunkStates);
+        }
+
+        rendered += chunk.tiles;
+    }
+
+    return rendered;
+}
@@ -0,0 +1,523 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "game/LevelFile.h"
+
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "game/LayerParser.h"
+#include "simplelogger.hpp"
+#include "tinyxml2.h"
+
+namespace
+{
+constexpr char COMPILED_MAGIC[4] = {'G', 'D', 'L', 'V'};
+constexpr uint32_t COMPILED_VERSION = 1;
+// Reads back differently on a machine with the other byte order
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/* Layout: header, tile sets, images, strings, then the map aligned to 4 bytes */
+struct CompiledHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t tileSetCount;
+
+    // Size and modification time of the tiled map it was compiled from
+    uint64_t sourceSize;
+    int64_t sourceTime;
+
+    int32_t width;
+    int32_t height;
+    int32_t tileWidth;
+    int32_t tileHeight;
+
+    uint32_t imageCount;
+    uint32_t stringsSize;
+    uint64_t mapOffset;
+};
+static_assert(sizeof(CompiledHeader) == 64);
+
+struct CompiledTileSet
+{
+    int32_t firstGid;
+    int32_t tileWidth;
+    int32_t tileHeight;
+    int32_t tileCount;
+    int32_t columnCount;
+    int32_t padding;
+
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t firstImage;
+    uint32_t imageCount;
+};
+static_assert(sizeof(CompiledTileSet) == 40);
+
+struct CompiledImage
+{
+    int32_t width;
+    int32_t height;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+};
+static_assert(sizeof(CompiledImage) == 16);
+
+struct SourceStamp
+{
+    uint64_t size = 0;
+    int64_t time = 0;
+};
+
+bool getSourceStamp(const std::string &filePath, SourceStamp &stamp)
+{
+    std::error_code error;
+    const auto size = std::filesystem::file_size(filePath, error);
+    if (error)
+        return false;
+    const auto time = std::filesystem::last_write_time(filePath, error);
+    if (error)
+        return false;
+
+    stamp.size = size;
+    stamp.time = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+size_t getMapOffset(const CompiledHeader &header)
+{
+    const size_t end = sizeof(CompiledHeader) + header.tileSetCount * sizeof(CompiledTileSet) +
+                       header.imageCount * sizeof(CompiledImage) + header.stringsSize;
+    return (end + alignof(uint32_t) - 1) / alignof(uint32_t) * alignof(uint32_t);
+}
+} // namespace
+
+std::string LevelData::getCompiledPath(const std::string &filePath)
+{
+    return std::filesystem::path(filePath).replace_extension(COMPILED_EXTENSION).string();
+}
+
+void LevelData::reset()
+{
+    m_size = sf::Vector2i(0, 0);
+    m_tileSize = sf::Vector2i(0, 0);
+    m_tileSets.clear();
+    m_map = {};
+    m_parsedMap.clear();
+    m_file.close();
+}
+
+bool LevelData::loadFromFile(const std::string &filePath)
+{
+    const std::string compiledPath = getCompiledPath(filePath);
+    if (std::filesystem::exists(compiledPath))
+    {
+        // Without the source there is nothing to be stale against
+        const std::string sourcePath = std::filesystem::exists(filePath) ? filePath : "";
+        if (loadCompiled(compiledPath, sourcePath))
+        {
+            SL_LOG_DEBUG(std::format("Loaded compiled level {}", compiledPath));
+            return true;
+        }
+
+        SL_LOG_INFO(std::format("Compiled level {} is unusable, falling back to {}", compiledPath, filePath));
+    }
+
+    return loadFromTmx(filePath);
+}
+
+bool LevelData::loadFromTmx(const std::string &filePath)
+{
+    reset();
+
+    tinyxml2::XMLDocument doc;
+    SL_LOG_DEBUG(std::format("Loading file: {}", filePath));
+    if (doc.LoadFile(filePath.c_str()) != tinyxml2::XML_SUCCESS)
+    {
+        SL_LOG_FATAL(std::format("Failed to load file: {}", filePath));
+        return false;
+    }
+
+    tinyxml2::XMLElement *rootNode = doc.RootElement();
+    if (rootNode == nullptr)
+    {
+        SL_LOG_FATAL("Failed to find root node");
+        return false;
+    }
+
+    // Process the nodes
+    if (rootNode->Name() == std::string("map"))
+    {
+        SL_LOG_DEBUG("Loading map");
+
+        if (rootNode->QueryIntAttribute("width", &m_size.x) != tinyxml2::XML_SUCCESS)
+        {
+            SL_LOG_FATAL("Failed to load width of map");
+            return false;
+        }
+        if (rootNode->QueryIntAttribute("height", &m_size.y) != tinyxml2::XML_SUCCESS)
+        {
+            SL_LOG_FATAL("Failed to load height of map");
+            return false;
+        }
+        if (rootNode->QueryIntAttribute("tilewidth", &m_tileSize.x) != tinyxml2::XML_SUCCESS)
+        {
+            SL_LOG_ERROR("Failed to load the Tile Width of map, defaulting to 64");
+            m_tileSize.x = 64;
+        }
+        if (rootNode->QueryIntAttribute("tileheight", &m_tileSize.y) != tinyxml2::XML_SUCCESS)
+        {
+            SL_LOG_ERROR("Failed to load the Tile Height of map, defaulting to 64");
+            m_tileSize.y = 64;
+        }
+    }
+    else
+    {
+        SL_LOG_FATAL(std::format("File: {} does not contain a map", filePath));
+        SL_LOG_DEBUG(std::format("File: {} contains root element {}", filePath, rootNode->Name()));
+        return false;
+    }
+
+    for (const tinyxml2::XMLElement *cNode = rootNode->FirstChildElement(); cNode != nullptr;
+         cNode = cNode->NextSiblingElement())
+    {
+        SL_LOG_DEBUG(std::format("Processing node {}", cNode->Name()));
+        if (cNode->Name() == std::string("tileset"))
+        {
+            TileSet tileSet;
+
+            SL_LOG_DEBUG(std::format("Loading tile set {}", cNode->Attribute("name")));
+
+            const char *nm;
+            if (cNode->QueryStringAttribute("name", &nm) != tinyxml2::XML_SUCCESS)
+            {
+                SL_LOG_ERROR("Failed to load name of tile set, defaulting to empty string");
+                nm = "";
+            }
+            tileSet.name = nm;
+
+            if (cNode->QueryIntAttribute("firstgid", &tileSet.firstGid) != tinyxml2::XML_SUCCESS)
+            {
+                SL_LOG_FATAL(std::format("Failed to load firstgid of tile set {}", tileSet.name));
+                return false;
+            }
+            if (cNode->QueryIntAttribute("tilewidth", &tileSet.tileWidth) != tinyxml2::XML_SUCCESS)
+            {
+                SL_LOG_ERROR(std::format("Failed to load tilewidth of tile set {}, defaulting to 64", tileSet.name));
+                tileSet.tileWidth = 64;
+            }
+            if (cNode->QueryIntAttribute("tileheight", &tileSet.tileHeight) != tinyxml2::XML_SUCCESS)
+            {
+                SL_LOG_ERROR(std::format("Failed to load tileheight of tile set {}, defaulting to 64", tileSet.name));
+                tileSet.tileHeight = 64;
+            }
+            if (cNode->QueryIntAttribute("tilecount", &tileSet.tileCount) != tinyxml2::XML_SUCCESS)
+            {
+                SL_LOG_WARNING("Tilesets with only a single frame are not supported");
+                tileSet.tileCount = 0;
+            }
+            if (cNode->QueryIntAttribute("columns", &tileSet.columnCount) != tinyxml2::XML_SUCCESS)
+            {
+                SL_LOG_WARNING("Tilesets with only a single frame are not supported");
+                tileSet.columnCount = 0;
+            }
+            if (cNode->QueryIntAttribute("padding", &tileSet.padding) != tinyxml2::XML_SUCCESS)
+            {
+                // Ignore
+                tileSet.padding = 0;
+            }
+
+            for (const tinyxml2::XMLElement *tileNode = cNode->FirstChildElement(); tileNode != nullptr;
+                 tileNode = tileNode->NextSiblingElement())
+            {
+                if (tileNode->Name() == std::string("image"))
+                {
+                    tileSet.tiles.push_back(TileSetImage(
+                            sf::Vector2i(tileNode->IntAttribute("width", 0), tileNode->IntAttribute("height", 0))));
+                    const char *src;
+                    if (tileNode->QueryAttribute("source", &src) != tinyxml2::XML_SUCCESS)
+                    {
+                        SL_LOG_ERROR(std::format("Failed to load source of tile set for image in tile set {}",
+                                                 tileSet.name));
+                        src = "";
+                    }
+                    tileSet.tiles.back().texture = src;
+                }
+            }
+
+            m_tileSets.push_back(std::move(tileSet));
+        }
+
+        if (cNode->Name() == std::string("layer"))
+        {
+            SL_LOG_DEBUG(std::format("Loading layer {}", cNode->Attribute("name")));
+            const tinyxml2::XMLElement *data = cNode->FirstChildElement();
+            if (data == nullptr)
+            {
+                SL_LOG_FATAL(std::format("Failed to load data of layer {}", cNode->Attribute("name")));
+                return false;
+            }
+            const char *encoding = data->Attribute("encoding");
+            const char *compression = data->Attribute("compression");
+            const std::string_view text = data->GetText() ? data->GetText() : "";
+
+            bool parsed = false;
+            if (encoding != nullptr and encoding == std::string("csv"))
+            {
+                parsed = parseLayer(text);
+            }
+            else if (encoding != nullptr and encoding == std::string("base64"))
+            {
+                LayerCompression layerCompression = LayerCompression::None;
+                if (compression == nullptr)
+                    layerCompression = LayerCompression::None;
+                else if (compression == std::string("zlib"))
+                    layerCompression = LayerCompression::Zlib;
+                else if (compression == std::string("gzip"))
+                    layerCompression = LayerCompression::Gzip;
+                else if (compression == std::string("zstd"))
+                    layerCompression = LayerCompression::Zstd;
+                else
+                {
+                    SL_LOG_FATAL(std::format("Unsupported compression <{}> of layer {}", compression,
+                                             cNode->Attribute("name")));
+                    return false;
+                }
+
+                parsed = parseLayer(text, layerCompression);
+            }
+            else
+            {
+                if (encoding == nullptr)
+                {
+                    SL_LOG_FATAL(std::format("Failed to load encoding of layer {}", cNode->Attribute("name")));
+                }
+                else
+                {
+                    SL_LOG_FATAL(
+                            std::format("Unsupported encoding <{}> of layer {}", encoding, cNode->Attribute("name")));
+                }
+                return false;
+            }
+
+            if (!parsed)
+            {
+                SL_LOG_FATAL(std::format("Failed to parse layer {}", cNode->Attribute("name")));
+                return false;
+            }
+        }
+    }
+
+    if (m_tileSets.empty())
+    {
+        SL_LOG_FATAL("Failed to load any tile sets");
+        return false;
+    }
+    if (m_map.empty())
+    {
+        SL_LOG_FATAL(std::format("File: {} does not contain a layer", filePath));
+        return false;
+    }
+    SL_LOG_DEBUG(std::format("Loaded {}", filePath));
+
+    return true;
+}
+
+bool LevelData::parseLayer(const std::string_view layer, const std::optional<LayerCompression> compression)
+{
+    const size_t cells = static_cast<size_t>(m_size.x) * m_size.y;
+    m_parsedMap.assign(cells, 0);
+    m_map = m_parsedMap;
+
+    size_t count = 0;
+    const bool parsed = compression ? parseBase64Layer(layer, *compression, m_parsedMap, count)
+                                    : parseCsvLayer(layer, m_parsedMap, count);
+    if (!parsed)
+        return false;
+
+    if (count != cells)
+    {
+        SL_LOG_WARNING("Layer is smaller than expected");
+        SL_LOG_DEBUG(std::format("Expected: {}, Got: {}", cells, count));
+    }
+
+    return true;
+}
+
+bool LevelData::loadCompiled(const std::string &filePath, const std::string &sourcePath)
+{
+    reset();
+
+    if (!m_file.open(filePath))
+        return false;
+
+    const std::span<const std::byte> data = m_file.getData();
+    const auto fail = [&](const std::string &reason)
+    {
+        SL_LOG_ERROR(std::format("Compiled level {} {}", filePath, reason));
+        reset();
+        return false;
+    };
+
+    CompiledHeader header{};
+    if (data.size() < sizeof(header))
+        return fail("is truncated");
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, COMPILED_MAGIC, sizeof(COMPILED_MAGIC)) != 0)
+        return fail("is not a compiled level");
+    if (header.byteOrder != BYTE_ORDER_MARK)
+        return fail("was compiled on a machine with a different byte order");
+    if (header.version != COMPILED_VERSION)
+        return fail(std::format("has version {}, expected {}", header.version, COMPILED_VERSION));
+
+    if (!sourcePath.empty())
+    {
+        SourceStamp stamp;
+        if (!getSourceStamp(sourcePath, stamp))
+            return fail(std::format("could not be checked against {}", sourcePath));
+        if (stamp.size != header.sourceSize or stamp.time != header.sourceTime)
+        {
+            // Expected while editing levels, so not an error
+            SL_LOG_INFO(std::format("Compiled level {} is older than {}", filePath, sourcePath));
+            reset();
+            return false;
+        }
+    }
+
+    if (header.width <= 0 or header.height <= 0)
+        return fail("has an empty map");
+
+    const size_t cells = static_cast<size_t>(header.width) * static_cast<size_t>(header.height);
+    if (header.mapOffset != getMapOffset(header) or header.mapOffset > data.size() or
+        (data.size() - header.mapOffset) / sizeof(uint32_t) < cells)
+        return fail("is truncated");
+
+    const std::byte *tileSets = data.data() + sizeof(CompiledHeader);
+    const std::byte *images = tileSets + header.tileSetCount * sizeof(CompiledTileSet);
+    const char *strings = reinterpret_cast<const char *>(images + header.imageCount * sizeof(CompiledImage));
+    const auto getString = [&](const uint32_t offset, const uint32_t length, std::string &out)
+    {
+        if (offset > header.stringsSize or length > header.stringsSize - offset)
+            return false;
+        out.assign(strings + offset, length);
+        return true;
+    };
+
+    m_tileSets.resize(header.tileSetCount);
+    for (uint32_t i = 0; i < header.tileSetCount; ++i)
+    {
+        CompiledTileSet compiled{};
+        std::memcpy(&compiled, tileSets + i * sizeof(CompiledTileSet), sizeof(compiled));
+
+        TileSet &tileSet = m_tileSets[i];
+        tileSet.firstGid = compiled.firstGid;
+        tileSet.tileWidth = compiled.tileWidth;
+        tileSet.tileHeight = compiled.tileHeight;
+        tileSet.tileCount = compiled.tileCount;
+        tileSet.columnCount = compiled.columnCount;
+        tileSet.padding = compiled.padding;
+        if (!getString(compiled.nameOffset, compiled.nameLength, tileSet.name))
+            return fail("has a corrupt tile set name");
+
+        if (compiled.firstImage > header.imageCount or compiled.imageCount > header.imageCount - compiled.firstImage)
+            return fail("has a corrupt image table");
+
+        tileSet.tiles.resize(compiled.imageCount);
+        for (uint32_t j = 0; j < compiled.imageCount; ++j)
+        {
+            CompiledImage image{};
+            std::memcpy(&image, images + (compiled.firstImage + j) * sizeof(CompiledImage), sizeof(image));
+
+            tileSet.tiles[j].size = sf::Vector2i(image.width, image.height);
+            if (!getString(image.pathOffset, image.pathLength, tileSet.tiles[j].texture))
+                return fail("has a corrupt image path");
+        }
+    }
+
+    if (m_tileSets.empty())
+        return fail("does not contain any tile sets");
+
+    m_size = sf::Vector2i(header.width, header.height);
+    m_tileSize = sf::Vector2i(header.tileWidth, header.tileHeight);
+    // Mapped memory is page aligned and the offset is a multiple of 4
+    m_map = std::span(reinterpret_cast<const uint32_t *>(data.data() + header.mapOffset), cells);
+
+    return true;
+}
+
+bool LevelData::saveCompiled(const std::string &filePath, const std::string &sourcePath) const
+{
+    SourceStamp stamp;
+    if (!getSourceStamp(sourcePath, stamp))
+    {
+        SL_LOG_ERROR(std::format("Failed to read the size and time of {}", sourcePath));
+        return false;
+    }
+
+    std::string strings;
+    std::vector<CompiledTileSet> tileSets;
+    std::vector<CompiledImage> images;
+    for (const auto &tileSet: m_tileSets)
+    {
+        tileSets.push_back(CompiledTileSet{tileSet.firstGid, tileSet.tileWidth, tileSet.tileHeight, tileSet.tileCount,
+                                           tileSet.columnCount, tileSet.padding,
+                                           static_cast<uint32_t>(strings.size()),
+                                           static_cast<uint32_t>(tileSet.name.size()),
+                                           static_cast<uint32_t>(images.size()),
+                                           static_cast<uint32_t>(tileSet.tiles.size())});
+        strings += tileSet.name;
+
+        for (const auto &tile: tileSet.tiles)
+        {
+            images.push_back(CompiledImage{tile.size.x, tile.size.y, static_cast<uint32_t>(strings.size()),
+                                           static_cast<uint32_t>(tile.texture.size())});
+            strings += tile.texture;
+        }
+    }
+
+    CompiledHeader header{};
+    std::memcpy(header.magic, COMPILED_MAGIC, sizeof(COMPILED_MAGIC));
+    header.version = COMPILED_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.tileSetCount = static_cast<uint32_t>(tileSets.size());
+    header.sourceSize = stamp.size;
+    header.sourceTime = stamp.time;
+    header.width = m_size.x;
+    header.height = m_size.y;
+    header.tileWidth = m_tileSize.x;
+    header.tileHeight = m_tileSize.y;
+    header.imageCount = static_cast<uint32_t>(images.size());
+    header.stringsSize = static_cast<uint32_t>(strings.size());
+    header.mapOffset = getMapOffset(header);
+
+    // Pad the strings so the map starts aligned
+    strings.resize(header.mapOffset - sizeof(CompiledHeader) - tileSets.size() * sizeof(CompiledTileSet) -
+                   images.size() * sizeof(CompiledImage));
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        SL_LOG_ERROR(std::format("Failed to open {} for writing", filePath));
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(tileSets.data()),
+               static_cast<std::streamsize>(tileSets.size() * sizeof(CompiledTileSet)));
+    file.write(reinterpret_cast<const char *>(images.data()),
+               static_cast<std::streamsize>(images.size() * sizeof(CompiledImage)));
+    file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    file.write(reinterpret_cast<const char *>(m_map.data()),
+               static_cast<std::streamsize>(m_map.size() * sizeof(uint32_t)));
+
+    if (!file)
+    {
+        SL_LOG_ERROR(std::format("Failed to write {}", filePath));
+        return false;
+    }
+
+    return true;
+}
@@ -7,9 +7,9 @@
 
 #include "GeometryDash.h"
 
-void PlayerAnimator::update()
+void PlayerAnimator::update(const float dt)
 {
-    m_dtCounter += GeometryDash::getInstance().getDeltaTime().asSeconds();
+    m_dtCounter += dt;
 
     if (m_dtCounter >= 1.0 / m_frameRate)
     {
@@ -22,12 +22,18 @@ void PlayerAnimator::update()
     }
 }
 
+void PlayerAnimator::reset()
+{
+    m_dtCounter = 0;
+    m_currentFrame = m_minFrame;
+}
+
 sf::IntRect &PlayerAnimator::render()
 {
     if (m_texFrameCount == sf::Vector2i(0, 0))
     {
-        m_rect.left = 0;
-        m_rect.top = 0;
+        m_rect.left = m_origin.x;
+        m_rect.top = m_origin.y;
         m_rect.height = m_size.y;
         m_rect.width = m_size.x;
 
@@ -36,55 +42,88 @@ sf::IntRect &PlayerAnimator::render()
 
     const sf::Vector2i frame(m_currentFrame % m_texFrameCount.x, std::floor(m_currentFrame / m_texFrameCount.x));
 
-    m_rect.left = frame.x * m_size.x + m_padding.x * frame.x;
-    m_rect.top = frame.y * m_size.y + m_padding.y * frame.y;
+    m_rect.left = m_origin.x + frame.x * m_size.x + m_padding.x * frame.x;
+    m_rect.top = m_origin.y + frame.y * m_size.y + m_padding.y * frame.y;
     m_rect.height = m_size.y;
     m_rect.width = m_size.x;
 
     return m_rect;
 }
 
+Player::Player(const sf::Vector2f &position, const sf::Vector2f &size, const PlayerAnimator &animator) :
+    m_position(position), m_previousPosition(position), m_spawnPosition(position), m_size(size), m_animator(animator)
+{
+}
+
 Player::Player(const sf::Texture &texture, const sf::Vector2f &position, const sf::Vector2f &size,
-               const PlayerAnimator &animator) :
-    m_sprite(texture), m_texture(texture), m_position(position), m_size(size), m_animator(animator)
+               const PlayerAnimator &animator) : Player(position, size, animator)
+{
+    // The texture may be a shared atlas, only ever show the animator's frame
+    m_sprite.setTexture(texture);
+    m_sprite.setTextureRect(m_animator.render());
+}
+
+void Player::reset()
 {
+    m_isDead = false;
+    m_onGround = false;
+    m_position = m_spawnPosition;
+    m_previousPosition = m_spawnPosition;
+    m_velocity = 0;
+    m_acceleration = 0;
+    m_holdingJump = false;
+    m_holdJumpLength = 0;
+
+    m_animator.reset();
+
+    // Same transform as a newly created sprite
+    m_sprite.setPosition(0, 0);
+    m_sprite.setRotation(0);
+    m_sprite.setScale(1, 1);
+    m_sprite.setTextureRect(m_animator.render());
 }
 
-void Player::update(Arena &arena)
+void Player::update(Arena &arena, const float dt)
 {
+    m_previousPosition = m_position;
     if (m_isDead)
     {
 
         return;
     }
 
-    m_animator.update();
+    m_animator.update(dt);
 
     if (!m_onGround)
     {
-        m_sprite.rotate(ROTATION_SPEED * GeometryDash::getInstance().getDeltaTime().asSeconds());
+        m_sprite.rotate(ROTATION_SPEED * dt);
     }
     else
     {
         m_sprite.setRotation(0);
     }
 
-    m_acceleration += GRAVITY * GeometryDash::getInstance().getDeltaTime().asSeconds();
+    m_acceleration += GRAVITY * dt;
     m_acceleration = std::clamp(m_acceleration, -MAX_ACCELERATION, MAX_ACCELERATION);
-    m_velocity += m_acceleration * GeometryDash::getInstance().getDeltaTime().asSeconds();
+    m_velocity += m_acceleration * dt;
     m_velocity = std::clamp(m_velocity, -MAX_VELOCITY, MAX_VELOCITY);
 
-    m_sprite.setPosition(m_position);
-    if (const ArenaItem *collide = arena.collidePlayer(m_sprite.getGlobalBounds()); collide != nullptr)
+    // The arena scrolled under the player, sweep from where the player was against it so nothing is skipped
+    const sf::Vector2f scroll = arena.getScrollDelta();
+    sf::FloatRect bounds = getBounds();
+    bounds.left -= scroll.x;
+    bounds.top -= scroll.y;
+    if (std::optional<TileSweep> collide = arena.sweepPlayer(bounds, scroll); collide)
     {
-        if (collide->getType() == ArenaItemType::Spike or collide->getType() == ArenaItemType::TinySpike)
+        if (collide->hit.type == ArenaItemType::Spike or collide->hit.type == ArenaItemType::TinySpike)
         {
             m_isDead = true;
             return; // No further processing to be done
         }
 
-        sf::Vector2f posC = m_sprite.getPosition();
-        posC.y = (collide->getPosition() - collide->getRelativePosition()).y - m_size.y;
+        // Running into the side of a block is only survivable when it is low enough to step onto
+        sf::Vector2f posC = m_position;
+        posC.y = (collide->hit.position - arena.getPosition()).y - m_size.y;
 
         if (std::abs(posC.y - m_position.y) > DEATH_THRESHOLD)
         {
@@ -94,7 +133,7 @@ void Player::update(Arena &arena)
 
         m_position = posC;
 
-        // SL_LOGF_DEBUG("Player collided with an object: {}", collide->getId());
+        // SL_LOGF_DEBUG("Player collided with a tile: {}", collide->hit.tile);
         if (m_acceleration > 0)
         {
             m_velocity = 0;
@@ -106,27 +145,41 @@ void Player::update(Arena &arena)
     else
     {
         m_onGround = false;
-        m_position.y += m_velocity * GeometryDash::getInstance().getDeltaTime().asSeconds();
-        m_sprite.setPosition(m_position);
-        if (collide = arena.collidePlayer(m_sprite.getGlobalBounds()); collide != nullptr)
+        // The whole fall is swept, however fast the player moves it stops at the first thing in the way
+        const sf::Vector2f fall(0, m_velocity * dt);
+        if (std::optional<TileSweep> collide = arena.sweepPlayer(getBounds(), fall); collide)
         {
-            if (collide->getType() == ArenaItemType::Spike or collide->getType() == ArenaItemType::TinySpike)
+            if (collide->hit.type == ArenaItemType::Spike or collide->hit.type == ArenaItemType::TinySpike)
             {
-                // SL_LOGF_DEBUG("Player collided with a spike: {}", collide->getId());
+                // SL_LOGF_DEBUG("Player collided with a spike: {}", collide->hit.tile);
                 m_isDead = true;
                 return; // No further processing to be done
             }
 
-            // Hit the floor
-            sf::Vector2f posC = m_sprite.getPosition();
-            posC.y = (collide->getPosition() - collide->getRelativePosition()).y - m_size.y;
-            m_position = posC;
+            if (collide->sweep.normal.y > 0)
+            {
+                // Hit a ceiling, stop underneath it
+                m_position.y += fall.y * collide->sweep.time;
+                m_velocity = 0;
+                m_acceleration = 0;
+            }
+            else
+            {
+                // Hit the floor
+                sf::Vector2f posC = m_position;
+                posC.y = (collide->hit.position - arena.getPosition()).y - m_size.y;
+                m_position = posC;
 
-            // SL_LOGF_DEBUG("Player collided with an object: {}", collide->getId());
-            m_velocity = 0;
-            m_acceleration = 0;
+                // SL_LOGF_DEBUG("Player collided with a tile: {}", collide->hit.tile);
+                m_velocity = 0;
+                m_acceleration = 0;
 
-            m_onGround = true;
+                m_onGround = true;
+            }
+        }
+        else
+        {
+            m_position.y += fall.y;
         }
     }
 
@@ -137,13 +190,13 @@ void Player::update(Arena &arena)
         // SL_LOG_DEBUG("Jumping");
         m_acceleration = JUMP_SPEED;
         m_velocity = JUMP_VELOCITY;
-        m_position.y += m_velocity * GeometryDash::getInstance().getDeltaTime().asSeconds();
+        m_position.y += m_velocity * dt;
         m_onGround = false;
         m_holdJumpLength = 0;
     }
     if (!m_holdingJump and m_holdJumpLength != 0)
     {
-        m_holdJumpLength -= GeometryDash::getInstance().getDeltaTime().asSeconds();
+        m_holdJumpLength -= dt;
         if (m_holdJumpLength <= 0)
         {
             // SL_LOG_DEBUG("Ran out of time");
@@ -153,9 +206,15 @@ void Player::update(Arena &arena)
     }
 }
 
-void Player::render(const sf::Vector2f &cameraPos)
+sf::Vector2f Player::getInterpolatedPosition(const float alpha) const
+{
+    return m_previousPosition + (m_position - m_previousPosition) * alpha;
+}
+
+void Player::render(const sf::Vector2f &cameraPos, const float alpha)
 {
-    m_sprite.setPosition(m_position + cameraPos);
+    const sf::Vector2f position = getInterpolatedPosition(alpha);
+    m_sprite.setPosition(position + cameraPos);
     m_sprite.setTextureRect(m_animator.render());
     m_sprite.setScale(m_size.x / static_cast<float>(m_animator.getSize().x),
                       m_size.y / static_cast<float>(m_animator.getSize().y));
@@ -166,7 +225,7 @@ void Player::render(const sf::Vector2f &cameraPos)
     if (GeometryDash::RenderCollisionShapes)
     {
         sf::RectangleShape rect{m_size};
-        rect.setPosition(m_position + cameraPos);
+        rect.setPosition(position + cameraPos);
         rect.setFillColor(sf::Color(20, 20, 20, 20));
         rect.setOutlineColor(sf::Color::Blue);
         rect.setOutlineThickness(1);
@@ -175,21 +234,31 @@ void Player::render(const sf::Vector2f &cameraPos)
 #endif // NDEBUG
 }
 
+std::optional<bool> Player::getJumpInput(const sf::Event &event)
+{
+    if (event.type == sf::Event::KeyPressed and event.key.code == sf::Keyboard::Space)
+        return true;
+    if (event.type == sf::Event::KeyReleased and event.key.code == sf::Keyboard::Space)
+        return false;
+
+    return std::nullopt;
+}
+
+void Player::pressJump()
+{
+    m_holdJumpLength = JUMP_THRESHOLD;
+    m_holdingJump = true;
+}
+
+void Player::releaseJump() { m_holdingJump = false; }
+
 void Player::handleEvent(const sf::Event &event)
 {
-    if (event.type == sf::Event::KeyPressed)
+    if (const std::optional<bool> jump = getJumpInput(event); jump)
     {
-        if (event.key.code == sf::Keyboard::Space)
-        {
-            m_holdJumpLength = JUMP_THRESHOLD;
-            m_holdingJump = true;
-        }
-    }
-    if (event.type == sf::Event::KeyReleased)
-    {
-        if (event.key.code == sf::Keyboard::Space)
-        {
-            m_holdingJump = false;
-        }
+        if (*jump)
+            pressJump();
+        else
+            releaseJump();
     }
 }
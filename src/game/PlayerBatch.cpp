@@ -0,0 +1,216 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "game/PlayerBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "game/Player.h"
+
+PlayerBatch::PlayerBatch(const size_t count, const sf::Vector2f &position, const sf::Vector2f &size) :
+    m_x(position.x), m_spawnPosition(position), m_size(size), m_y(count), m_velocity(count), m_acceleration(count),
+    m_holdJumpLength(count), m_onGround(count), m_dead(count), m_holdingJump(count)
+{
+    reset();
+}
+
+void PlayerBatch::reset()
+{
+    m_x = m_spawnPosition.x;
+    std::ranges::fill(m_y, m_spawnPosition.y);
+    std::ranges::fill(m_velocity, 0.0f);
+    std::ranges::fill(m_acceleration, 0.0f);
+    std::ranges::fill(m_holdJumpLength, 0.0);
+    std::ranges::fill(m_onGround, 0);
+    std::ranges::fill(m_dead, 0);
+    std::ranges::fill(m_holdingJump, 0);
+}
+
+size_t PlayerBatch::getAliveCount() const
+{
+    return static_cast<size_t>(std::ranges::count(m_dead, 0));
+}
+
+void PlayerBatch::pressJump(const size_t player)
+{
+    m_holdJumpLength[player] = JUMP_THRESHOLD;
+    m_holdingJump[player] = 1;
+}
+
+void PlayerBatch::update(const Arena &arena, const float dt, const size_t first, const size_t last)
+{
+    // Kept per thread so ticks don't allocate
+    thread_local std::vector<size_t> candidates;
+    thread_local ColliderBatch colliders;
+    thread_local std::vector<size_t> falling;
+
+    // Gravity for everyone at once, the same sums in the same order as Player::update. Dead players keep their state
+    for (size_t i = first; i < last; ++i)
+    {
+        const float acceleration = std::clamp(m_acceleration[i] + GRAVITY * dt, -MAX_ACCELERATION, MAX_ACCELERATION);
+        const float velocity = std::clamp(m_velocity[i] + acceleration * dt, -MAX_VELOCITY, MAX_VELOCITY);
+        m_acceleration[i] = m_dead[i] != 0 ? m_acceleration[i] : acceleration;
+        m_velocity[i] = m_dead[i] != 0 ? m_velocity[i] : velocity;
+    }
+
+    // One broad phase covering every player, padded by a tile so rounding never leaves out a cell one of them needs
+    const float padding = static_cast<float>(arena.getTileSize().y);
+    const auto gather = [&](const float top, const float bottom, const sf::Vector2f &delta)
+    {
+        candidates.clear();
+        colliders.clear();
+        if (top > bottom)
+            return;
+
+        const sf::FloatRect shape{m_x - delta.x, top - padding, m_size.x, bottom - top + padding * 2};
+        arena.getLevel().forEachCandidate(arena.getSweepCells(shape, delta),
+                                          [&arena](const size_t tile)
+                                          {
+                                              candidates.push_back(tile);
+                                              arena.getLevel().addCollider(tile, colliders);
+                                              return true;
+                                          });
+    };
+
+    // The arena scrolled under the players, sweep from where they were against it
+    const sf::Vector2f scroll = arena.getScrollDelta();
+    float top = INFINITY;
+    float bottom = -INFINITY;
+    for (size_t i = first; i < last; ++i)
+    {
+        if (m_dead[i] != 0)
+            continue;
+        top = std::min(top, m_y[i] - scroll.y);
+        bottom = std::max(bottom, m_y[i] - scroll.y + m_size.y);
+    }
+    gather(top, bottom, scroll);
+
+    falling.clear();
+    top = INFINITY;
+    bottom = -INFINITY;
+    for (size_t i = first; i < last; ++i)
+    {
+        if (m_dead[i] != 0)
+            continue;
+
+        const sf::FloatRect bounds{m_x - scroll.x, m_y[i] - scroll.y, m_size.x, m_size.y};
+        const std::optional<TileSweep> collide = arena.sweepShape(bounds, scroll, candidates, colliders);
+        if (!collide)
+        {
+            m_onGround[i] = 0;
+            falling.push_back(i);
+
+            const float fall = m_velocity[i] * dt;
+            top = std::min(top, m_y[i] + std::min(fall, 0.0f));
+            bottom = std::max(bottom, m_y[i] + m_size.y + std::max(fall, 0.0f));
+            continue;
+        }
+
+        if (collide->hit.type == ArenaItemType::Spike or collide->hit.type == ArenaItemType::TinySpike)
+        {
+            m_dead[i] = 1;
+            continue;
+        }
+
+        // Running into the side of a block is only survivable when it is low enough to step onto
+        const float y = (collide->hit.position - arena.getPosition()).y - m_size.y;
+        if (std::abs(y - m_y[i]) > DEATH_THRESHOLD)
+        {
+            m_dead[i] = 1;
+            continue;
+        }
+
+        m_y[i] = y;
+        if (m_acceleration[i] > 0)
+        {
+            m_velocity[i] = 0;
+            m_acceleration[i] = 0;
+        }
+        m_onGround[i] = 1;
+    }
+
+    // Everyone who didn't land on something while scrolling falls, swept as a whole
+    gather(top, bottom, {0, 0});
+    for (const size_t i: falling)
+    {
+        const sf::Vector2f fall(0, m_velocity[i] * dt);
+        const std::optional<TileSweep> collide = arena.sweepShape({m_x, m_y[i], m_size.x, m_size.y}, fall, candidates,
+                                                                   colliders);
+        if (!collide)
+        {
+            m_y[i] += fall.y;
+            continue;
+        }
+
+        if (collide->hit.type == ArenaItemType::Spike or collide->hit.type == ArenaItemType::TinySpike)
+        {
+            m_dead[i] = 1;
+            continue;
+        }
+
+        if (collide->sweep.normal.y > 0)
+        {
+            // Hit a ceiling, stop underneath it
+            m_y[i] += fall.y * collide->sweep.time;
+        }
+        else
+        {
+            // Hit the floor
+            m_y[i] = (collide->hit.position - arena.getPosition()).y - m_size.y;
+            m_onGround[i] = 1;
+        }
+        m_velocity[i] = 0;
+        m_acceleration[i] = 0;
+    }
+
+    // Jumps, again for everyone at once
+    for (size_t i = first; i < last; ++i)
+    {
+        if (m_dead[i] != 0)
+            continue;
+
+        if (m_onGround[i] != 0 and m_holdJumpLength[i] != 0)
+        {
+            m_acceleration[i] = JUMP_SPEED;
+            m_velocity[i] = JUMP_VELOCITY;
+            m_y[i] += m_velocity[i] * dt;
+            m_onGround[i] = 0;
+            m_holdJumpLength[i] = 0;
+        }
+        if (m_holdingJump[i] == 0 and m_holdJumpLength[i] != 0)
+        {
+            m_holdJumpLength[i] -= dt;
+            if (m_holdJumpLength[i] <= 0)
+                m_holdJumpLength[i] = 0;
+        }
+    }
+}
+
+void PlayerBatch::simulate(Arena &arena, const float dt, const uint32_t ticks, const unsigned threads,
+                           const Input &input)
+{
+    const auto run = [&](const size_t first, const size_t last)
+    {
+        // An arena is only the progress of a run, a copy per thread keeps them from sharing its scratch
+        Arena own = arena;
+        for (uint32_t tick = 0; tick < ticks; ++tick)
+        {
+            if (input)
+                input(*this, first, last, tick);
+            own.update(dt);
+            update(own, dt, first, last);
+        }
+    };
+
+    const size_t count = std::clamp<size_t>(threads, 1, std::max<size_t>(size(), 1));
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(count - 1);
+        for (size_t t = 1; t < count; ++t)
+            workers.emplace_back(run, size() * t / count, size() * (t + 1) / count);
+        run(0, size() / count);
+    }
+
+    for (uint32_t tick = 0; tick < ticks; ++tick)
+        arena.update(dt);
+}
@@ -0,0 +1,110 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "game/Replay.h"
+
+#include <format>
+#include <utility>
+
+#include "simplelogger.hpp"
+#include "tinyxml2.h"
+
+Replay::Replay(std::string level, const int tickRate) : m_level(std::move(level)), m_tickRate(tickRate) {}
+
+void Replay::record(const uint32_t tick, const bool pressed)
+{
+    SL_ASSERT(m_events.empty() or m_events.back().tick <= tick, "Replay events have to be recorded in tick order");
+    m_events.push_back(ReplayEvent{tick, pressed});
+}
+
+void Replay::clear()
+{
+    m_ticks = 0;
+    m_events.clear();
+}
+
+bool Replay::loadFromFile(const std::string &filePath)
+{
+    tinyxml2::XMLDocument doc;
+    if (const tinyxml2::XMLError error = doc.LoadFile(filePath.c_str()); error != tinyxml2::XML_SUCCESS)
+    {
+        SL_LOGF_ERROR("Failed to load replay {}: {}", filePath, doc.ErrorIDToName(error));
+        return false;
+    }
+
+    const tinyxml2::XMLElement *root = doc.FirstChildElement("replay");
+    if (root == nullptr)
+    {
+        SL_LOGF_ERROR("Failed to find root element in replay {}", filePath);
+        return false;
+    }
+    if (const int version = root->IntAttribute("version"); version != VERSION)
+    {
+        SL_LOGF_ERROR("Replay {} has version {}, only version {} is supported", filePath, version, VERSION);
+        return false;
+    }
+
+    const char *level = root->Attribute("level");
+    m_level = level != nullptr ? level : "";
+    m_tickRate = root->IntAttribute("tickRate");
+    m_ticks = root->UnsignedAttribute("ticks");
+    if (m_level.empty() or m_tickRate <= 0)
+    {
+        SL_LOGF_ERROR("Replay {} is missing its level or tick rate", filePath);
+        return false;
+    }
+
+    m_events.clear();
+    for (const tinyxml2::XMLElement *event = root->FirstChildElement("event"); event != nullptr;
+         event = event->NextSiblingElement("event"))
+    {
+        const uint32_t tick = event->UnsignedAttribute("tick");
+        if (!m_events.empty() and tick < m_events.back().tick)
+        {
+            SL_LOGF_ERROR("Replay {} has events out of order at tick {}", filePath, tick);
+            return false;
+        }
+
+        m_events.push_back(ReplayEvent{tick, event->BoolAttribute("pressed")});
+    }
+
+    SL_LOGF_DEBUG("Loaded replay {} of {} with {} events over {} ticks", filePath, m_level, m_events.size(), m_ticks);
+    return true;
+}
+
+bool Replay::saveToFile(const std::string &filePath) const
+{
+    tinyxml2::XMLDocument doc;
+
+    tinyxml2::XMLElement *root = doc.NewElement("replay");
+    doc.InsertFirstChild(root);
+    root->SetAttribute("version", VERSION);
+    root->SetAttribute("level", m_level.c_str());
+    root->SetAttribute("tickRate", m_tickRate);
+    root->SetAttribute("ticks", m_ticks);
+
+    for (const auto &[tick, pressed]: m_events)
+    {
+        tinyxml2::XMLElement *event = root->InsertNewChildElement("event");
+        event->SetAttribute("tick", tick);
+        event->SetAttribute("pressed", pressed);
+    }
+
+    if (const tinyxml2::XMLError error = doc.SaveFile(filePath.c_str()); error != tinyxml2::XML_SUCCESS)
+    {
+        SL_LOGF_ERROR("Failed to save replay {}: {}", filePath, doc.ErrorIDToName(error));
+        return false;
+    }
+
+    return true;
+}
+
+void ReplayPlayback::apply(const uint32_t tick, Player &player)
+{
+    const std::vector<ReplayEvent> &events = m_replay->getEvents();
+    for (; m_next < events.size() and events[m_next].tick <= tick; ++m_next)
+    {
+        if (events[m_next].pressed)
+            player.pressJump();
+        else
+            player.releaseJump();
+    }
+}
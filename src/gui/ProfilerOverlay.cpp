@@ -0,0 +1,67 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include "gui/ProfilerOverlay.h"
+
+#include <format>
+
+#include "AssetManager.h"
+#include "GeometryDash.h"
+#include "Profiler.h"
+
+void ProfilerOverlay::create()
+{
+    AssetManager::getInstance().loadFont("assets/fonts/mangabey-regular.otf", "mangabey");
+    m_font = AssetManager::getInstance().getFont("mangabey");
+
+    m_text.setFont(m_font);
+    m_text.setCharacterSize(18);
+    m_text.setFillColor(sf::Color::White);
+
+    m_background = Panel(sf::Vector2f(0, 0), sf::Vector2f(0, 0), PanelStyle(sf::Color(0, 0, 0, 170)));
+    m_sinceRefresh = REFRESH_TIME;
+}
+
+void ProfilerOverlay::update(const float dt)
+{
+    if (!Profiler::IsEnabled())
+        return;
+
+    m_sinceRefresh += dt;
+    if (m_sinceRefresh < REFRESH_TIME)
+        return;
+    m_sinceRefresh = 0;
+
+    const Profiler &profiler = Profiler::getInstance();
+    const double frame = profiler.getFrameMilliseconds();
+    std::string text = std::format("Frame {:.2f} ms ({:.0f} FPS)\n", frame, frame > 0 ? 1000 / frame : 0.0);
+    for (const ZoneStats &zone: profiler.getFrameStats())
+    {
+        text += std::format("{:{}}{} {:.3f} ms", "", zone.depth * 4, zone.name, zone.milliseconds);
+        // Zones that run once a frame don't need their count
+        if (zone.calls < 0.95 or zone.calls > 1.05)
+            text += std::format(" x{:.1f}", zone.calls);
+        text += '\n';
+    }
+    m_text.setString(text);
+
+    // Under the pause and settings buttons
+    const sf::FloatRect bounds = m_text.getLocalBounds();
+    const float width = bounds.left + bounds.width + 20;
+    const float windowWidth = static_cast<float>(GeometryDash::getInstance().getWindow().getWindow().getSize().x);
+    m_text.setPosition(windowWidth - width + 10, 70);
+    m_background.setPosition(sf::Vector2f(windowWidth - width, 65));
+    m_background.setSize(sf::Vector2f(width, bounds.top + bounds.height + 15));
+}
+
+void ProfilerOverlay::render()
+{
+    if (!Profiler::IsEnabled())
+        return;
+
+    // Drawn in window coordinates whatever view the state left behind
+    sf::RenderWindow &window = GeometryDash::getInstance().getWindow().getWindow();
+    const sf::View view = window.getView();
+    window.setView(window.getDefaultView());
+    m_background.render();
+    window.draw(m_text);
+    window.setView(view);
+}
@@ -0,0 +1,274 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "Profiler.h"
+#include "game/Arena.h"
+#include "game/Level.h"
+#include "game/Player.h"
+#include "game/Replay.h"
+#include "simplelogger.hpp"
+
+/* Plays a level without a window as fast as possible, the clock is just a tick counter and the input is scripted
+ * or comes from a replay. Replays are a fixed workload, so ticks per second can be compared between builds
+ * Usage: Headless [level.tmx] [--rate ticks per second] [--ticks max ticks per run] [--runs count]
+ *                 [--jump-every ticks] [--hold ticks] [--replay file] [--record file] [--trace file]
+ *   --trace profiles the ticks and saves the last of them as a Chrome trace */
+namespace
+{
+// The same setup PlayState plays with in the default window
+const sf::Vector2f PLAYER_SPAWN{150, 300};
+const sf::Vector2f PLAYER_SIZE{32, 32};
+const sf::Vector2f SCROLL_SPEED{250, 0};
+const sf::Vector2f VIEWPORT_SIZE{1200, 800};
+
+struct Options
+{
+    std::string level;
+    int rate = 240;
+    int maxTicks = 0;
+    int runs = 1;
+    int jumpEvery = 0;
+    int hold = 1;
+    // Plays this replay instead of the scripted jumps
+    std::string replay;
+    // Saves the scripted jumps of the first run here
+    std::string record;
+    std::string trace;
+};
+
+bool parseInt(const char *text, int &value)
+{
+    const char *end = text + std::strlen(text);
+    const auto [ptr, error] = std::from_chars(text, end, value);
+    return error == std::errc() and ptr == end;
+}
+
+bool parseOptions(const int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg.starts_with("--"))
+        {
+            if (i + 1 >= argc)
+            {
+                SL_LOGF_ERROR("Missing value for {}", arg);
+                return false;
+            }
+
+            if (arg == "--replay" or arg == "--record" or arg == "--trace")
+            {
+                (arg == "--replay" ? options.replay : arg == "--record" ? options.record : options.trace) = argv[++i];
+                continue;
+            }
+
+            int *value = nullptr;
+            if (arg == "--rate")
+                value = &options.rate;
+            else if (arg == "--ticks")
+                value = &options.maxTicks;
+            else if (arg == "--runs")
+                value = &options.runs;
+            else if (arg == "--jump-every")
+                value = &options.jumpEvery;
+            else if (arg == "--hold")
+                value = &options.hold;
+
+            if (value == nullptr or !parseInt(argv[++i], *value) or *value < 0)
+            {
+                SL_LOGF_ERROR("Invalid option {} {}", arg, argv[i]);
+                return false;
+            }
+            continue;
+        }
+
+        options.level = arg;
+    }
+
+    if ((options.level.empty() and options.replay.empty()) or options.rate <= 0)
+    {
+        SL_LOG_ERROR("Usage: Headless [level.tmx] [--rate ticks per second] [--ticks max ticks per run] "
+                     "[--runs count] [--jump-every ticks] [--hold ticks] [--replay file] [--record file] "
+                     "[--trace file]");
+        return false;
+    }
+
+    return true;
+}
+
+enum class Outcome
+{
+    Finished,
+    Died,
+    Fell,
+    OutOfTicks
+};
+
+const char *getOutcomeName(const Outcome outcome)
+{
+    switch (outcome)
+    {
+        case Outcome::Finished:
+            return "finished";
+        case Outcome::Died:
+            return "died";
+        case Outcome::Fell:
+            return "fell";
+        case Outcome::OutOfTicks:
+        default:
+            return "out of ticks";
+    }
+}
+
+sf::Event makeJumpEvent(const sf::Event::EventType type)
+{
+    sf::Event event{};
+    event.type = type;
+    event.key.code = sf::Keyboard::Space;
+    return event;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    SL_CAPTURE_EXCEPTIONS();
+    slog::SimpleLogger::GlobalLogger()->setMinLogLevel(slog::LogLevel::INFO);
+
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    // A replay only plays back the same at the rate it was recorded at
+    Replay replay;
+    const bool playback = !options.replay.empty();
+    if (playback)
+    {
+        if (!replay.loadFromFile(options.replay))
+            return 1;
+
+        if (options.level.empty())
+            options.level = replay.getLevel();
+        options.rate = replay.getTickRate();
+        if (options.maxTicks == 0 and replay.getTicks() != 0)
+            options.maxTicks = static_cast<int>(replay.getTicks());
+    }
+    else
+    {
+        replay = Replay(options.level, options.rate);
+    }
+    ReplayPlayback input(replay);
+
+    // Only the tiles are needed, nothing is ever drawn
+    const auto level = std::make_shared<Level>();
+    if (!level->loadFromFile(options.level, {}, false))
+    {
+        SL_LOGF_ERROR("Failed to load {}", options.level);
+        return 1;
+    }
+
+    const float dt = 1.0f / static_cast<float>(options.rate);
+    const float levelWidth = static_cast<float>(level->getSize().x * level->getTileSize().x);
+    // Long enough to scroll through the whole level twice over
+    const int maxTicks = options.maxTicks > 0
+                                 ? options.maxTicks
+                                 : static_cast<int>(levelWidth / SCROLL_SPEED.x * static_cast<float>(options.rate)) * 2;
+
+    Arena arena;
+    arena.setLevel(level);
+    arena.setViewportSize(VIEWPORT_SIZE);
+    arena.setScrollSpeed(SCROLL_SPEED);
+    Player player(PLAYER_SPAWN, PLAYER_SIZE,
+                  PlayerAnimator(sf::Vector2f(64, 64), sf::Vector2i(), 0, 0, 10, sf::Vector2i(0, 0)));
+
+    // Only what the ring buffer can hold is kept, the end of the last run
+    Profiler::SetEnabled(!options.trace.empty());
+
+    long long totalTicks = 0;
+    bool diverged = false;
+    const auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < options.runs; ++run)
+    {
+        arena.reset();
+        player.reset();
+        input.rewind();
+
+        Outcome outcome = Outcome::OutOfTicks;
+        int tick = 0;
+        for (; tick < maxTicks; ++tick)
+        {
+            ProfileZone zone("tick");
+            if (playback)
+            {
+                input.apply(tick, player);
+            }
+            else if (options.jumpEvery > 0)
+            {
+                // Goes through the same path as live input, only the first run is recorded
+                const auto jump = [&](const sf::Event::EventType type)
+                {
+                    const sf::Event event = makeJumpEvent(type);
+                    if (run == 0)
+                        replay.record(tick, *Player::getJumpInput(event));
+                    player.handleEvent(event);
+                };
+                if (tick % options.jumpEvery == 0)
+                    jump(sf::Event::KeyPressed);
+                if (tick % options.jumpEvery == options.hold % options.jumpEvery)
+                    jump(sf::Event::KeyReleased);
+            }
+
+            arena.update(dt);
+            player.update(arena, dt);
+
+            if (player.isDead())
+                outcome = Outcome::Died;
+            else if (player.getPosition().y > VIEWPORT_SIZE.y)
+                outcome = Outcome::Fell;
+            else if (arena.getPosition().x + player.getPosition().x >= levelWidth)
+                outcome = Outcome::Finished;
+            else
+                continue;
+
+            ++tick;
+            break;
+        }
+
+        totalTicks += tick;
+        std::cout << std::format("run {}: {} after {} ticks ({:.2f}s), x {:.1f}\n", run, getOutcomeName(outcome),
+                                 tick, static_cast<float>(tick) * dt, arena.getPosition().x + player.getPosition().x);
+
+        if (playback and replay.getTicks() != 0 and static_cast<uint32_t>(tick) != replay.getTicks())
+        {
+            SL_LOGF_WARNING("Run {} ended after {} ticks but the replay ended after {}", run, tick,
+                            replay.getTicks());
+            diverged = true;
+        }
+        if (run == 0 and !playback)
+            replay.finish(static_cast<uint32_t>(tick));
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double ticksPerSecond = static_cast<double>(totalTicks) / std::max(elapsed.count(), 1e-9);
+    std::cout << std::format("{} ticks in {:.3f}s, {:.0f} ticks/s, {:.0f}x real time at {} ticks per second\n",
+                             totalTicks, elapsed.count(), ticksPerSecond,
+                             ticksPerSecond / static_cast<double>(options.rate), options.rate);
+
+    if (!options.trace.empty() and !Profiler::getInstance().saveChromeTrace(options.trace))
+        return 1;
+
+    if (!options.record.empty() and !playback)
+    {
+        if (!replay.saveToFile(options.record))
+            return 1;
+        SL_LOGF_INFO("Recorded the first run to {}", options.record);
+    }
+
+    return diverged ? 1 : 0;
+}
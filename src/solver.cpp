@@ -0,0 +1,534 @@
+/* Created by Matthew Brown on 10/17/2026 */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "game/Arena.h"
+#include "game/Level.h"
+#include "game/Player.h"
+#include "game/Replay.h"
+#include "simplelogger.hpp"
+
+/* Searches for a way through a level by trying both holding and not holding jump on every tick. Runs that die are
+ * dropped, and runs that reach a state some other run already reached are dropped too, so the search only ever
+ * follows each distinct state once. With --quantum states that are only nearly the same are merged as well, which is
+ * much faster but can drop the only way through. The search is spread over every core, idle threads steal the oldest
+ * unexplored branches of busy ones
+ * Usage: Solver level.tmx [--rate ticks per second] [--threads count] [--step ticks between decisions]
+ *               [--quantum pixels] [--max-states count] [--out replay file] */
+namespace
+{
+// The same setup PlayState plays with in the default window
+const sf::Vector2f PLAYER_SPAWN{150, 300};
+const sf::Vector2f PLAYER_SIZE{32, 32};
+const sf::Vector2f SCROLL_SPEED{250, 0};
+const sf::Vector2f VIEWPORT_SIZE{1200, 800};
+
+struct Options
+{
+    std::string level;
+    int rate = 240;
+    int threads = 0;
+    int step = 1;
+    // States closer than this are taken as the same one, in pixels and pixels per second. 0 only merges states that
+    // are exactly the same, anything else means a failed search proves nothing
+    float quantum = 0;
+    int maxStates = 50'000'000;
+    // Saves the winning input as a replay
+    std::string out;
+};
+
+bool parseInt(const char *text, int &value)
+{
+    const char *end = text + std::strlen(text);
+    const auto [ptr, error] = std::from_chars(text, end, value);
+    return error == std::errc() and ptr == end;
+}
+
+bool parseFloat(const char *text, float &value)
+{
+    const char *end = text + std::strlen(text);
+    const auto [ptr, error] = std::from_chars(text, end, value);
+    return error == std::errc() and ptr == end;
+}
+
+bool parseOptions(const int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg.starts_with("--"))
+        {
+            if (i + 1 >= argc)
+            {
+                SL_LOGF_ERROR("Missing value for {}", arg);
+                return false;
+            }
+
+            if (arg == "--out")
+            {
+                options.out = argv[++i];
+                continue;
+            }
+
+            bool valid = false;
+            if (arg == "--rate")
+                valid = parseInt(argv[++i], options.rate) and options.rate > 0;
+            else if (arg == "--threads")
+                valid = parseInt(argv[++i], options.threads) and options.threads >= 0;
+            else if (arg == "--step")
+                valid = parseInt(argv[++i], options.step) and options.step > 0;
+            else if (arg == "--quantum")
+                valid = parseFloat(argv[++i], options.quantum) and options.quantum >= 0;
+            else if (arg == "--max-states")
+                valid = parseInt(argv[++i], options.maxStates) and options.maxStates > 0;
+            else
+                ++i;
+
+            if (!valid)
+            {
+                SL_LOGF_ERROR("Invalid option {} {}", arg, argv[i]);
+                return false;
+            }
+            continue;
+        }
+
+        options.level = arg;
+    }
+
+    if (options.level.empty())
+    {
+        SL_LOG_ERROR("Usage: Solver level.tmx [--rate ticks per second] [--threads count] "
+                     "[--step ticks between decisions] [--quantum pixels] [--max-states count] [--out replay file]");
+        return false;
+    }
+
+    return true;
+}
+
+/* The jumps that led to a state, newest first. Branches share everything before the tick they split at */
+struct InputPath
+{
+    ReplayEvent event;
+    std::shared_ptr<const InputPath> previous;
+};
+
+/* A run partway through the level. The arena only depends on the tick, a thread's own arena is moved to the scroll
+ * of whichever run it follows */
+struct Node
+{
+    ArenaScroll scroll;
+    Player player;
+    uint32_t tick = 0;
+    std::shared_ptr<const InputPath> path;
+    // The input for this tick was already picked, the other one is explored by whoever picked it
+    bool decided = false;
+
+    /* Presses jump if it is released and the other way around, from this tick on */
+    void toggleJump()
+    {
+        const bool press = !player.isHoldingJump();
+        if (press)
+            player.pressJump();
+        else
+            player.releaseJump();
+        path = std::make_shared<const InputPath>(InputPath{ReplayEvent{tick, press}, path});
+        decided = true;
+    }
+};
+
+/* What the rest of a run depends on, the bits of every value or, with a quantum, the values rounded to it. The arena
+ * only depends on the tick */
+struct StateKey
+{
+    uint32_t tick = 0;
+    uint32_t y = 0;
+    uint32_t velocity = 0;
+    uint32_t acceleration = 0;
+    uint64_t holdJump = 0;
+    uint8_t flags = 0;
+
+    bool operator==(const StateKey &) const = default;
+};
+
+struct StateKeyHash
+{
+    size_t operator()(const StateKey &key) const
+    {
+        uint64_t hash = 0xcbf29ce484222325;
+        const auto mix = [&hash](const uint64_t value)
+        {
+            hash ^= value;
+            hash *= 0x100000001b3;
+            hash ^= hash >> 29;
+        };
+        mix(key.tick);
+        mix(key.y);
+        mix(key.velocity);
+        mix(key.acceleration);
+        mix(key.holdJump);
+        mix(key.flags);
+        return hash;
+    }
+};
+
+StateKey makeKey(const Node &node, const float quantum)
+{
+    const Player &player = node.player;
+    const uint8_t flags = (player.isOnGround() ? 1 : 0) | (player.isHoldingJump() ? 2 : 0);
+    if (quantum == 0)
+    {
+        return StateKey{node.tick,
+                        std::bit_cast<uint32_t>(player.getPosition().y),
+                        std::bit_cast<uint32_t>(player.getVelocity()),
+                        std::bit_cast<uint32_t>(player.getAcceleration()),
+                        std::bit_cast<uint64_t>(player.getHoldJumpLength()),
+                        flags};
+    }
+
+    const auto round = [quantum](const double value) { return static_cast<uint32_t>(std::lround(value / quantum)); };
+    return StateKey{node.tick,
+                    round(player.getPosition().y),
+                    round(player.getVelocity()),
+                    round(player.getAcceleration()),
+                    // Only ever a few ticks long, keep it to the tick
+                    static_cast<uint64_t>(std::llround(player.getHoldJumpLength() * 1e5)),
+                    flags};
+}
+
+/* Every state reached so far, split into shards so threads rarely wait on each other */
+class VisitedStates
+{
+public:
+    /* False when the state was reached before */
+    bool insert(const StateKey &key)
+    {
+        const size_t hash = StateKeyHash{}(key);
+        Shard &shard = m_shards[hash % SHARDS];
+        const std::lock_guard lock(shard.mutex);
+        if (!shard.keys.insert(key).second)
+            return false;
+
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    [[nodiscard]] size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t SHARDS = 256;
+    struct Shard
+    {
+        std::mutex mutex;
+        std::unordered_set<StateKey, StateKeyHash> keys;
+    };
+    std::array<Shard, SHARDS> m_shards;
+    std::atomic<size_t> m_size = 0;
+};
+
+/* A deque per thread. The owner works on the newest branches, which keeps it depth first and its runs hot in cache,
+ * while thieves take the oldest ones, which are the biggest untouched parts of the tree */
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(const size_t threads) : m_queues(threads) {}
+
+    void push(const size_t worker, Node node)
+    {
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        Queue &queue = m_queues[worker];
+        const std::lock_guard lock(queue.mutex);
+        queue.nodes.push_back(std::move(node));
+    }
+
+    std::optional<Node> pop(const size_t worker)
+    {
+        if (std::optional<Node> node = take(worker, false); node)
+            return node;
+
+        for (size_t i = 1; i < m_queues.size(); ++i)
+        {
+            if (std::optional<Node> node = take((worker + i) % m_queues.size(), true); node)
+                return node;
+        }
+        return std::nullopt;
+    }
+
+    /* A popped node and everything it pushed has been dealt with */
+    void done() { m_pending.fetch_sub(1, std::memory_order_acq_rel); }
+    /* Nothing is queued or being worked on, so nothing can be pushed anymore either */
+    [[nodiscard]] bool finished() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Node> nodes;
+    };
+    std::vector<Queue> m_queues;
+    std::atomic<size_t> m_pending = 0;
+
+    std::optional<Node> take(const size_t worker, const bool oldest)
+    {
+        Queue &queue = m_queues[worker];
+        const std::lock_guard lock(queue.mutex);
+        if (queue.nodes.empty())
+            return std::nullopt;
+
+        Node node = std::move(oldest ? queue.nodes.front() : queue.nodes.back());
+        if (oldest)
+            queue.nodes.pop_front();
+        else
+            queue.nodes.pop_back();
+        return node;
+    }
+};
+
+/* The furthest a thread got */
+struct Progress
+{
+    float x = 0;
+    uint32_t ticks = 0;
+    std::shared_ptr<const InputPath> path;
+    size_t simulated = 0;
+};
+
+class Solver
+{
+public:
+    Solver(const Options &options, const std::shared_ptr<const Level> &level, const size_t threads) :
+        m_options(options), m_pool(threads), m_progress(threads),
+        m_dt(1.0f / static_cast<float>(options.rate)),
+        m_levelWidth(static_cast<float>(level->getSize().x * level->getTileSize().x)),
+        // Long enough to scroll through the whole level twice over
+        m_maxTicks(static_cast<uint32_t>(m_levelWidth / SCROLL_SPEED.x * static_cast<float>(options.rate)) * 2)
+    {
+        m_arena.setLevel(level);
+        m_arena.setViewportSize(VIEWPORT_SIZE);
+        m_arena.setScrollSpeed(SCROLL_SPEED);
+    }
+
+    /* Searches until a run finishes the level or every branch is dead */
+    void solve()
+    {
+        Node root{m_arena.getScroll(),
+                  Player(PLAYER_SPAWN, PLAYER_SIZE,
+                         PlayerAnimator(sf::Vector2f(64, 64), sf::Vector2i(), 0, 0, 10, sf::Vector2i(0, 0))),
+                  0, nullptr, false};
+        m_pool.push(0, std::move(root));
+
+        std::vector<std::jthread> threads;
+        threads.reserve(m_progress.size());
+        for (size_t worker = 0; worker < m_progress.size(); ++worker)
+        {
+            threads.emplace_back([this, worker] { work(worker); });
+        }
+    }
+
+    [[nodiscard]] bool isSolved() const { return m_solved.load(); }
+    [[nodiscard]] bool isOutOfStates() const { return m_outOfStates.load(); }
+    [[nodiscard]] const VisitedStates &getVisited() const { return m_visited; }
+
+    /* The winning run if there is one, otherwise the one that got the furthest */
+    [[nodiscard]] const Progress &getBest() const
+    {
+        if (m_solved)
+            return m_solution;
+        return *std::ranges::max_element(m_progress, {}, &Progress::x);
+    }
+
+    [[nodiscard]] size_t getSimulatedTicks() const
+    {
+        size_t simulated = 0;
+        for (const Progress &progress: m_progress)
+            simulated += progress.simulated;
+        return simulated;
+    }
+
+private:
+    const Options &m_options;
+    // Every thread simulates in its own copy, the runs only keep their scroll
+    Arena m_arena;
+    WorkStealingPool m_pool;
+    VisitedStates m_visited;
+    std::vector<Progress> m_progress;
+    const float m_dt;
+    const float m_levelWidth;
+    const uint32_t m_maxTicks;
+
+    std::atomic<bool> m_solved = false;
+    std::atomic<bool> m_outOfStates = false;
+    std::mutex m_solutionMutex;
+    Progress m_solution;
+
+    [[nodiscard]] bool isStopped() const
+    {
+        return m_solved.load(std::memory_order_relaxed) or m_outOfStates.load(std::memory_order_relaxed);
+    }
+
+    void work(const size_t worker)
+    {
+        Arena arena = m_arena;
+        while (!isStopped())
+        {
+            if (std::optional<Node> node = m_pool.pop(worker); node)
+            {
+                follow(worker, arena, std::move(*node));
+                m_pool.done();
+            }
+            else if (m_pool.finished())
+            {
+                return;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /* Follows a run with the input it has until it dies or joins another one, leaving the other input on every
+     * decision tick in the pool */
+    void follow(const size_t worker, Arena &arena, Node node)
+    {
+        Progress &progress = m_progress[worker];
+        arena.setScroll(node.scroll);
+        while (!isStopped() and node.tick < m_maxTicks)
+        {
+            if (!node.decided and node.tick % m_options.step == 0)
+            {
+                Node branch = node;
+                branch.toggleJump();
+                m_pool.push(worker, std::move(branch));
+            }
+
+            arena.update(m_dt);
+            node.player.update(arena, m_dt);
+            node.scroll = arena.getScroll();
+            ++node.tick;
+            node.decided = false;
+            ++progress.simulated;
+
+            if (node.player.isDead() or node.player.getPosition().y > VIEWPORT_SIZE.y)
+                return;
+
+            const float x = arena.getPosition().x + node.player.getPosition().x;
+            if (x > progress.x)
+                progress = Progress{x, node.tick, node.path, progress.simulated};
+
+            if (x >= m_levelWidth)
+            {
+                const std::lock_guard lock(m_solutionMutex);
+                if (!m_solved)
+                {
+                    m_solution = Progress{x, node.tick, node.path, 0};
+                    m_solved = true;
+                }
+                return;
+            }
+
+            if (!m_visited.insert(makeKey(node, m_options.quantum)))
+                return;
+            if (m_visited.size() >= static_cast<size_t>(m_options.maxStates))
+            {
+                m_outOfStates = true;
+                return;
+            }
+        }
+    }
+};
+
+/* The jumps of a run in the order they happened */
+std::vector<ReplayEvent> getEvents(const std::shared_ptr<const InputPath> &path)
+{
+    std::vector<ReplayEvent> events;
+    for (const InputPath *input = path.get(); input != nullptr; input = input->previous.get())
+        events.push_back(input->event);
+    std::ranges::reverse(events);
+    return events;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    SL_CAPTURE_EXCEPTIONS();
+    slog::SimpleLogger::GlobalLogger()->setMinLogLevel(slog::LogLevel::INFO);
+
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    // Only the tiles are needed, nothing is ever drawn
+    const auto level = std::make_shared<Level>();
+    if (!level->loadFromFile(options.level, {}, false))
+    {
+        SL_LOGF_ERROR("Failed to load {}", options.level);
+        return 1;
+    }
+
+    const size_t threads = options.threads > 0 ? static_cast<size_t>(options.threads)
+                                               : std::max(1u, std::thread::hardware_concurrency());
+    Solver solver(options, level, threads);
+
+    const auto start = std::chrono::steady_clock::now();
+    solver.solve();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const Progress &best = solver.getBest();
+    const std::vector<ReplayEvent> events = getEvents(best.path);
+    const float dt = 1.0f / static_cast<float>(options.rate);
+    if (solver.isSolved())
+        std::cout << std::format("Solved after {} ticks ({:.2f}s)\n", best.ticks, static_cast<float>(best.ticks) * dt);
+    else if (solver.isOutOfStates())
+        std::cout << std::format("No way through found within the state limit, the furthest run reached x {:.1f} after "
+                                 "{} ticks ({:.2f}s)\n",
+                                 best.x, best.ticks, static_cast<float>(best.ticks) * dt);
+    else if (options.quantum > 0)
+        // Merged states can play out differently, so this doesn't rule out a way through
+        std::cout << std::format("No way through found with states merged within {}, the furthest run reached x {:.1f} "
+                                 "after {} ticks ({:.2f}s)\n",
+                                 options.quantum, best.x, best.ticks, static_cast<float>(best.ticks) * dt);
+    else
+        std::cout << std::format("No way through, the furthest run reached x {:.1f} after {} ticks ({:.2f}s)\n",
+                                 best.x, best.ticks, static_cast<float>(best.ticks) * dt);
+
+    for (const auto &[tick, pressed]: events)
+    {
+        std::cout << std::format("  tick {} ({:.3f}s) {}\n", tick, static_cast<float>(tick) * dt,
+                                 pressed ? "press" : "release");
+    }
+
+    const size_t simulated = solver.getSimulatedTicks();
+    std::cout << std::format("{} states, {} ticks simulated in {:.3f}s on {} threads, {:.0f} ticks/s\n",
+                             solver.getVisited().size(), simulated, elapsed.count(), threads,
+                             static_cast<double>(simulated) / std::max(elapsed.count(), 1e-9));
+
+    if (!options.out.empty())
+    {
+        Replay replay(options.level, options.rate);
+        for (const auto &[tick, pressed]: events)
+            replay.record(tick, pressed);
+        // Only a finished run is known to end there, the others are played until they end on their own
+        replay.finish(solver.isSolved() ? best.ticks : 0);
+        if (!replay.saveToFile(options.out))
+            return 1;
+        SL_LOGF_INFO("Saved the run to {}", options.out);
+    }
+
+    return solver.isSolved() ? 0 : 2;
+}